@@ -4,19 +4,79 @@ using std::queue;
 using std::vector;
 using std::unordered_map;
 
-// temprary variable
-typedef struct Temp_Var
+// 6502a opcodes, valued by their machine code
+enum Opcode
 {
-	bool string; // true if this is a string temporary variable
-	int address; // codePointer + address = address of the real variable
-	queue<int> addresses; // addresses of the temprary variables in the runtime environment
-} Temp_Var;
+	OP_LDA_CONST = 169, // A9 - load the accumulator with a constant
+	OP_LDA_MEM = 173, // AD - load the accumulator from memory
+	OP_STA = 141, // 8D - store the accumulator in memory
+	OP_ADC = 109, // 6D - add with carry
+	OP_LDX_CONST = 162, // A2 - load the X register with a constant
+	OP_LDX_MEM = 174, // AE - load the X register from memory
+	OP_LDY_CONST = 160, // A0 - load the Y register with a constant
+	OP_LDY_MEM = 172, // AC - load the Y register from memory
+	OP_NOP = 234, // EA - no operation
+	OP_BRK = 0, // 00 - break
+	OP_CPX = 236, // EC - set Z = 1 if the X register equals memory
+	OP_BNE = 208, // D0 - branch if Z = 0
+	OP_INC = 238, // EE - increment a byte in memory
+	OP_SYS = 255, // FF - system call
+	OP_LABEL = -1 // not an instruction - binds a label to where the next instruction goes
+};
+
+// kinds of instruction operands
+enum Operand
+{
+	OPD_NONE, // no operand
+	OPD_CONST, // a constant
+	OPD_STRING, // the address of a string literal, by index
+	OPD_VAR, // the memory of a variable, by slot
+	OPD_CELL, // a temporary memory cell, by number
+	OPD_LABEL // a branch target, by label
+};
+
+// 6502a instruction with a symbolic operand
+typedef struct Instruction
+{
+	Opcode op; // the opcode
+	Operand operand; // what kind of operand the instruction has
+	int value; // the constant, string index, slot, cell or label of the operand
+	int host; // the cell kept in this instruction's high address byte (-1 if none)
+} Instruction;
+
+// registers (and the Z flag) instructions read and write
+enum Register
+{
+	REG_A, // the accumulator
+	REG_X, // the X register
+	REG_Y, // the Y register
+	REG_Z // the Z flag
+};
+
+// value known to be in a register or memory
+typedef struct Content
+{
+	Operand operand; // OPD_CONST or OPD_STRING, OPD_VAR or OPD_CELL for the value in that memory, or OPD_NONE if unknown
+	int value; // the constant, string index, slot or cell
+} Content;
+
+class Code_Generator;
+
+// peephole optimization pattern
+typedef struct Peephole
+{
+	string name; // what the pattern matches
+	bool (Code_Generator::*apply)(int); // rewrites the code at an index, returning true if the pattern matched
+	int matches; // number of times the pattern was applied
+	int bytes; // bytes saved
+	int cycles; // cycles saved, counting each instruction once
+} Peephole;
 
 class Code_Generator
 {
 	// public class access
 	public:
-		Code_Generator(AST_Node&, unordered_map<string, int>&, bool); // constructor
+		Code_Generator(vector<AST_Node>&, unordered_map<string, int>&, bool); // constructor
 		int numErrors; // number of errors
 		int numWarn; // number of warnings
 		int runtime_environment [256]; // the runtime environment array
@@ -24,55 +84,151 @@ class Code_Generator
 	// private class access
 	private:
 		bool verbose; // verbose output
+		vector<AST_Node> AST; // the abstract syntax tree, in pre-order
+		vector<Instruction> code; // the instructions the AST is lowered to
+		vector<Peephole> peepholes; // the peephole optimization patterns
+		Peephole skipped; // loads and stores skipped while generating because the value was already in place
+		Peephole preloaded; // declarations whose starting value is placed in memory instead of stored
+		Peephole reused; // expressions loaded from where they were already computed instead of computed again
+		Peephole hoisted; // computations moved in front of the loops that repeated them
+		map<string, Content> available; // the memory holding each expression already computed, by its key, while generating
+		map<string, pair<int, int> > costs; // the bytes and cycles of the code computing each expression the first time
+		int pending; // the <+> whose value is in the accumulator, to be remembered where it is stored (-1 if none)
+		vector<Content> holds[3]; // everything the A, X and Y registers are known to equal while generating
+		Content known[3]; // contents of the A, X and Y registers while optimizing
+		map<pair<Operand, int>, Content> memory; // contents of variables and cells while optimizing
 		int codePointer; // points to where code goes in the runtime environment
 		int stopPointer; // points to where code should stop in the runtime environment
 		int value; // value for int expressions
-		unordered_map<string, Temp_Var> tempTable; // temporary variables table
-		vector<int> jumps; // alters jump values for ifstream
-		vector<int> revertTo0; // fixes memory so loops can reuse comparisons
+		int numSlots; // number of variable slots that need memory
+		vector<int> initial; // the byte each variable slot starts with in the runtime environment
+		vector<bool> declared; // the slots a declaration or store was already generated for
+		int loops; // number of loops around the code being generated
+		int numCells; // number of temporary cells created
+		int numLabels; // number of labels created
+		int result; // the cell holding the result of the last comparison
+		int trueString; // index of the string literal "true"
+		int falseString; // index of the string literal "false"
+		vector<int> scratch; // scratch cell given to each temporary cell (-1 if it stays in its store's high address byte)
+		int numScratch; // number of scratch cells after the variables
+		vector<int> stringAddresses; // memory addresses of the string literals, indexed by the value of their AST nodes
 		void printRuntimeEnvironment(); // prints the runtime environment out
-		void addStrings(unordered_map<string, int>&); // adds string literals to runtime environment
-		void addTemps(AST_Node&); // adds temporary variables to the temp table
-		void generateCode(AST_Node&, unordered_map<string, int>&); // generates the code
-		void cpPP(); // increments code pointer
-		void addTemp(AST_Node&, int); // adds a temporary address to the temp table
-		void replaceTemps(); // replaces temporary variables with memory addresses
+		void addStrings(unordered_map<string, int>&); // packs the string literals the code uses into the runtime environment
+		void countSlots(); // counts the variable slots
+		void generateCode(int); // lowers the AST to instructions
+		int increment(int, int); // the constant a <+> adds to a variable
+		int counter(int); // the variable a counting loop counts with
+		void emit(Opcode, Operand = OPD_NONE, int = 0, int = -1); // appends an instruction
+		bool satisfied(Instruction&); // true if a load or store would not change its register or memory
+		void remember(Instruction&); // updates what the registers hold after an instruction
+		string key(int); // the key of an expression, the same for every expression computing the same value
+		bool reusable(int); // true if an expression can be loaded from where it was computed before
+		bool reuse(int); // loads an expression from where it was computed before, if it was
+		void computed(int, int); // remembers what computing an expression cost
+		void kill(int); // forgets the expressions that read or are kept in a variable
+		vector<bool> assigns(int); // the variables a loop assigns
+		void killLoop(int); // forgets the expressions that read a variable a loop assigns
+		void preheader(int); // computes the comparisons a loop repeats in front of it
+		void hoist(int); // moves the loads a loop repeats in front of it
+		void meet(map<string, Content>&); // keeps only the expressions also available on another path
+		int newCell(); // creates a temporary cell
+		int storeCell(); // stores the accumulator in a new temporary cell
+		void compareZero(); // compares the X register with a byte that is always 0
+		int newLabel(); // creates an unbound label
+		void bindLabel(int); // binds a label to the next instruction
+		void branchTo(int); // emits a branch to a label
+		void jump(int); // emits an unconditional jump to a label
+		void compareSides(int); // compares both sides of a comparison
+		void branchIfFalse(int, int); // branches to a label if a comparison is false
+		int size(Opcode); // the size of an instruction in bytes
+		int cycles(Opcode); // the cycles an instruction takes
+		void optimize(); // applies the peephole patterns until none match
+		void track(Instruction&); // updates the known contents for an instruction
+		void printPeepholes(); // prints the peephole optimization report
+		bool reads(Opcode, Register); // true if an instruction reads a register
+		bool writes(Opcode, Register); // true if an instruction writes a register
+		bool live(int, Register); // true if a register may be read before it is written
+		int references(Operand, int); // counts the instructions referencing a cell or label
+		int labelIndex(int); // finds where a label is bound
+		Register target(Opcode); // the register a load writes
+		bool storeReload(int);
+		bool loadStore(int);
+		bool knownLoad(int);
+		bool constantMemory(int);
+		bool compareKnownZero(int);
+		bool deadStore(int);
+		bool deadLoad(int);
+		bool foldDiamond(int);
+		void allocateCells(); // gives temporary cells stored in loops a scratch cell
+		void assemble(); // encodes the instructions into the runtime environment
 		void create6502aCode(); // function to turn the code into a string
 		void hexTrace(); // for testing
 };
 
 // constructor
-Code_Generator::Code_Generator(AST_Node& AST, unordered_map<string, int>& stringsMap, bool v)
+Code_Generator::Code_Generator(vector<AST_Node>& tree, unordered_map<string, int>& stringsMap, bool v)
 {
 	// variable initialization
 	verbose = v; // set verbose to on or off
+	AST = tree; // the flat AST copies in one go
 	numErrors = 0; // start with no errors
 	numWarn = 0; // start with no warnings
 	codePointer = 0; // start code at first byte
 	value = 0;
+	numCells = 0; // no temporary cells yet
+	numLabels = 0; // no labels yet
+	result = 0;
+	loops = 0; // not in a loop yet
+	skipped = {"load or store of a value already in place (while generating)", nullptr, 0, 0, 0};
+	preloaded = {"declaration run once, its starting value placed in memory", nullptr, 0, 0, 0};
+	reused = {"expression already computed, reused (value numbering)", nullptr, 0, 0, 0};
+	hoisted = {"loop-invariant code moved in front of its loop (cycles per time around)", nullptr, 0, 0, 0};
+	pending = -1; // nothing in the accumulator yet
+	// the peephole optimization patterns, tried in this order at every instruction
+	peepholes = {
+		{"store then reload (STA m; LDA m)", &Code_Generator::storeReload, 0, 0, 0},
+		{"store of a loaded value (LDA m; STA m)", &Code_Generator::loadStore, 0, 0, 0},
+		{"unconditional jump in a boolean diamond", &Code_Generator::foldDiamond, 0, 0, 0},
+		{"load of a constant already in the register", &Code_Generator::knownLoad, 0, 0, 0},
+		{"load of memory holding a known constant", &Code_Generator::constantMemory, 0, 0, 0},
+		{"compare with memory holding a known 0", &Code_Generator::compareKnownZero, 0, 0, 0},
+		{"store into a cell that is never read", &Code_Generator::deadStore, 0, 0, 0},
+		{"load into a register that is never read", &Code_Generator::deadLoad, 0, 0, 0}
+	};
 	stopPointer = 255; // stop at byte 255 to start - this will change as string literals are added
 	// fill the runtime environment with 00s
 	for(int i = 0; i < 256; ++i)
 		runtime_environment[i] = 0;
-	
-	// add all string literals to the runtime environment
-	addStrings(stringsMap);
-	
-	// add the necessary temporary variables
-	addTemps(AST);
-	
-	// generate the code
-	generateCode(AST, stringsMap);
+
+	// give "true" and "false" an index for printing boolean literals (if they don't already exist)
+	trueString = stringsMap.emplace("true", stringsMap.size()).first->second;
+	falseString = stringsMap.emplace("false", stringsMap.size()).first->second;
+
+	// count the variables that need memory
+	countSlots();
+
+	// lower the AST to instructions
+	generateCode(0); // start at the root
 	// append the 00 byte to signify the EOP
-	runtime_environment[codePointer] = 0;
-	cpPP();
-	
-	// replace temporary variable with their memory addresses
-	replaceTemps();
-	
+	emit(OP_BRK);
+
+	// remove redundant instructions
+	optimize();
+
+	// share scratch memory between the temporary cells that need it
+	allocateCells();
+
+	// add the string literals the code still uses to the runtime environment
+	addStrings(stringsMap);
+
+	// lay the instructions out and encode them, placing variables and scratch cells after the code
+	assemble();
+
 	// verbose mode reporting
 	if(verbose)
 	{
+		// report the peephole optimizations
+		printPeepholes();
 		// trace the creation of the 6502a codes
 		hexTrace();
 		// print the runtime environment
@@ -83,846 +239,1384 @@ Code_Generator::Code_Generator(AST_Node& AST, unordered_map<string, int>& string
 		printRuntimeEnvironment();
 		cout << "___|__________________________________________________________________" << endl;
 	}
-	
+
 	// push the code to a string for outputting to a text file
 	create6502aCode();
 }
 
-// function to add a temporary variable to the temporary variable table
-// var		: the AST node containnig the temporary variable
-// address	: the address of the temporary variable
-void Code_Generator::addTemp(AST_Node& var, int address)
+// function to append an instruction to the code
+// op		: the opcode
+// operand	: the kind of operand
+// value	: the operand
+// host		: the cell kept in the instruction's high address byte (-1 if none)
+void Code_Generator::emit(Opcode op, Operand operand, int value, int host)
 {
-	stringstream keyStream;
-	keyStream << var.name.at(1) << "@" << var.scope << "-" << var.subscope;
-	string key = keyStream.str();
-	Temp_Var& temp = tempTable.at(key);
-	temp.addresses.push(address);
+	Instruction ins = {op, operand, value, host};
+	if(satisfied(ins)) // the value is already in place, so skip the instruction
+	{
+		++skipped.matches;
+		skipped.bytes += size(op);
+		skipped.cycles += cycles(op);
+		return;
+	}
+	code.push_back(ins);
+	remember(ins);
 }
 
-// function to replace temporary variables
-void Code_Generator::replaceTemps()
+// function to find the key of an expression
+// two expressions with the same key compute the same value as long as no variable they read is assigned in between
+// n	: index of the expression
+string Code_Generator::key(int n)
 {
-	for ( auto it = tempTable.begin(); it != tempTable.end(); ++it )
+	AST_Node& node = AST[n];
+	switch(node.kind)
 	{
-		Temp_Var& temp = it->second;
-		while(!temp.addresses.empty()) // for each temporary variable address
-		{
-			runtime_environment[temp.addresses.front()] = codePointer; // set temp variable to memory address that holds the real variable
-			temp.addresses.pop();
-		}
-		cpPP(); // increment the code pointer
+		case N_ID:
+			return "v" + to_string(node.slot) + ",";
+		case N_DIGIT:
+			return to_string(node.value) + ",";
+		case N_TRUE:
+			return "t,";
+		case N_FALSE:
+			return "f,";
+		case N_CHARS:
+			return "s" + to_string(node.value) + ",";
+		case N_ADD:
+			return "+" + key(n+1) + key(AST[n+1].end);
+		case N_EQUAL:
+			return "=" + key(n+1) + key(AST[n+1].end);
+		case N_NOT_EQUAL:
+			return "!" + key(n+1) + key(AST[n+1].end);
+		default:
+			return "?";
 	}
 }
 
-// function to increment the code pointer and report out of memory errors
-void Code_Generator::cpPP() // "code pointer plus plus"
+// function to check if an expression is worth loading from where it was computed before
+// it has to read a variable (the constant folder already did the rest), and no <+> in it may pass the maximum value,
+// since that warning is given for each one
+// n	: index of the expression
+bool Code_Generator::reusable(int n)
 {
-	++codePointer; // increment the code pointer
-	// increment all jump values relevant
-	for(vector<int>::iterator it = jumps.begin() ; it != jumps.end(); ++it)
-		runtime_environment[*it] = runtime_environment[*it] + 1;
-	if(codePointer > stopPointer) // if we ran out of memory
+	bool reads = false; // true if the expression reads a variable
+	for(int i = n; i < AST[n].end; ++i)
 	{
-		codePointer = stopPointer; // prevent trying to access unreachable memory
-		if(numErrors < 1) // if we haven't yet reported this, do so
-		{
-			cout << "[ERROR]" << ": (OOM) " << "The runtime environment is out of memory. Please limit your program to 256 bytes." << endl;
-			++numErrors; // increment the number of errors
-		}
+		if(AST[i].kind == N_ID) reads = true;
+		int sum = 0;
+		for(int rest = i; AST[rest].kind == N_ADD; rest = AST[rest+1].end)
+			sum += AST[rest+1].value;
+		if(sum > 255) return false;
 	}
+	return reads;
 }
 
-// function to generate the byte code
-// ast			: the abstract syntax tree being used
-// stringsMap	: map of strings in memory
-void Code_Generator::generateCode(AST_Node& ast, unordered_map<string, int>& stringsMap)
+// function to load an expression from where it was computed before, if it was and nothing it reads has been assigned since
+// a <+> is loaded into the accumulator, while a comparison simply becomes the result it already stored
+// n	: index of the <+>, <==> or <!=>
+// returns true if the expression was reused
+bool Code_Generator::reuse(int n)
 {
-	// variables
-	string name = ast.name;
-	string type = ast.type;
-	vector<AST_Node>& children = *ast.children;
-	
-	if(name == "<Block>")
+	if(!reusable(n)) return false;
+	map<string, Content>::iterator it = available.find(key(n));
+	if(it == available.end()) return false;
+	pair<int, int> cost = costs[it->first];
+	++reused.matches;
+	if(AST[n].kind == N_ADD)
 	{
-		// recurse on child nodes
-		for(vector<AST_Node>::iterator it=children.begin(); it != children.end(); ++it) // for each child node
-			generateCode(*it, stringsMap); // recurse
+		emit(OP_LDA_MEM, it->second.operand, it->second.value);
+		pending = n; // stored again wherever the caller stores it
+		cost.first -= size(OP_LDA_MEM);
+		cost.second -= cycles(OP_LDA_MEM);
 	}
-	else if(name == "<VarDecl>")
+	else
+		result = it->second.value; // the cell holding the result
+	reused.bytes += cost.first;
+	reused.cycles += cost.second;
+	return true;
+}
+
+// function to remember the bytes and cycles of the code that computed an expression, for the report
+// n	: index of the expression
+// from	: index of the first instruction computing it
+void Code_Generator::computed(int n, int from)
+{
+	if(!reusable(n)) return;
+	pair<int, int> cost(0, 0);
+	for(int i = from; i < (int)code.size(); ++i)
 	{
-		AST_Node& var = children.at(1); // the variable
-		runtime_environment[codePointer] = 169;
-		cpPP(); // increment code pointer
-		// set the memoy address of uninitialzed variables to 0 if not a string (reference type), or the last byte for strings (empty string)
-		if(var.type == "string") runtime_environment[codePointer] = 255;
-		else runtime_environment[codePointer] = 0;
-		cpPP();
-		runtime_environment[codePointer] = 141;
-		cpPP();
-		runtime_environment[codePointer] = 0;
-		addTemp(var, codePointer); // temp var
-		cpPP();
-		runtime_environment[codePointer] = 0;
-		cpPP();
-		return;
+		cost.first += size(code[i].op);
+		cost.second += cycles(code[i].op);
 	}
-	else if(name == "<AssignmentStatement>")
+	costs.emplace(key(n), cost);
+}
+
+// function to forget the expressions that read a variable, or are kept in it, once it is assigned
+// slot	: the slot of the variable
+void Code_Generator::kill(int slot)
+{
+	string id = "v" + to_string(slot) + ","; // the key of the variable
+	for(map<string, Content>::iterator it = available.begin(); it != available.end();)
 	{
-		if(children.at(1).name.length() == 3 && children.at(1).name.at(1) > 96 && children.at(1).name.at(1) < 123) // if the assignment is one variable to another
+		if(it->first.find(id) != string::npos || (it->second.operand == OPD_VAR && it->second.value == slot))
+			it = available.erase(it);
+		else
+			++it;
+	}
+}
+
+// function to find the variables a loop assigns
+// n	: index of the while statement
+// returns true for each slot assigned or declared in the loop
+vector<bool> Code_Generator::assigns(int n)
+{
+	vector<bool> slots(numSlots, false);
+	for(int i = n; i < AST[n].end; ++i)
+	{
+		if(AST[i].kind == N_ASSIGNMENT_STATEMENT)
+			slots[AST[i+1].slot] = true;
+		else if(AST[i].kind == N_VAR_DECL)
+			slots[AST[AST[i+1].end].slot] = true;
+	}
+	return slots;
+}
+
+// function to forget the expressions that read a variable a loop assigns, since the loop may come back around after it does
+// n	: index of the while statement
+void Code_Generator::killLoop(int n)
+{
+	vector<bool> slots = assigns(n);
+	for(int s = 0; s < numSlots; ++s)
+	{
+		if(slots[s]) kill(s);
+	}
+}
+
+// function to compute the comparisons in a loop that read nothing the loop assigns once, in front of it
+// each one is then available to the loop, which takes its result instead of comparing again every time around
+// only comparisons that store a result are moved - the conditions of if and while statements branch instead
+// n	: index of the while statement
+void Code_Generator::preheader(int n)
+{
+	vector<bool> slots = assigns(n);
+	vector<bool> condition(AST.size(), false); // the conditions of the if and while statements
+	for(int i = n; i < AST[n].end; ++i)
+	{
+		if(AST[i].kind == N_IF_STATEMENT || AST[i].kind == N_WHILE_STATEMENT)
+			condition[i+1] = true;
+	}
+	for(int i = n+1; i < AST[n].end; ++i)
+	{
+		if((AST[i].kind != N_EQUAL && AST[i].kind != N_NOT_EQUAL) || condition[i] || !reusable(i)) continue;
+		string k = key(i);
+		bool invariant = available.count(k) == 0; // not already computed
+		for(int s = 0; s < numSlots && invariant; ++s)
+			invariant = !slots[s] || k.find("v" + to_string(s) + ",") == string::npos;
+		if(!invariant) continue;
+		generateCode(i); // computed here and made available
+		++hoisted.matches;
+		hoisted.cycles += costs[k].second;
+		i = AST[i].end - 1; // the comparisons inside it came along
+	}
+}
+
+// function to move the loads a loop repeats in front of it
+// a load can move when it is the only instruction in the loop setting its register, nothing in the loop stores to what it loads,
+// and the register isn't read before the load sets it, in the loop or after it if the loop never runs
+// start	: index of the first instruction of the loop
+void Code_Generator::hoist(int start)
+{
+	for(int i = start; i < (int)code.size(); ++i)
+	{
+		Instruction ins = code[i];
+		if(ins.op != OP_LDA_CONST && ins.op != OP_LDX_CONST && ins.op != OP_LDY_CONST &&
+			ins.op != OP_LDA_MEM && ins.op != OP_LDX_MEM && ins.op != OP_LDY_MEM) continue;
+		if(ins.host >= 0 || ins.operand == OPD_CELL) continue; // cells belong to where they are stored
+		Register reg = target(ins.op);
+		bool invariant = true;
+		for(int j = start; j < (int)code.size() && invariant; ++j)
 		{
-			AST_Node& var1 = children.at(0); // the variable to assign
-			AST_Node& var2 = children.at(1); // the variable assigning
-			// load variable to give value
-			runtime_environment[codePointer] = 173; // ad
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			addTemp(var2, codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// store variable to get value
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			addTemp(var1, codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
+			if(j == i) continue;
+			if(writes(code[j].op, reg)) invariant = false; // something else sets the register
+			if((code[j].op == OP_STA || code[j].op == OP_INC) && code[j].operand == ins.operand && code[j].value == ins.value)
+				invariant = false; // what it loads changes
 		}
-		else if(type == "int")
-		{
-			AST_Node& var = children.at(0); // the variable
-			if(children.at(1).name.length() == 3 && children.at(1).name.at(1) > 47 && children.at(1).name.at(1) < 58) // if the assignment is simply a digit
-			{
-				int num = children.at(1).name.at(1) - 48;
-				runtime_environment[codePointer] = 169; // a9
-				cpPP();
-				runtime_environment[codePointer] = num;
-				cpPP();
-				runtime_environment[codePointer] = 141; // 8d
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				addTemp(var, codePointer); // temp var
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				cpPP();
-			}
-			else // assignment had a <+> in it
+		if(!invariant || live(start, reg)) continue;
+		code.erase(code.begin()+i);
+		code.insert(code.begin()+start, ins);
+		++start; // the loop starts after it now
+		++hoisted.matches;
+		hoisted.cycles += cycles(ins.op);
+	}
+}
+
+// function to keep only the expressions that are also available, in the same memory, on another path
+// other	: the expressions available on the other path
+void Code_Generator::meet(map<string, Content>& other)
+{
+	for(map<string, Content>::iterator it = available.begin(); it != available.end();)
+	{
+		map<string, Content>::iterator match = other.find(it->first);
+		if(match == other.end() || match->second.operand != it->second.operand || match->second.value != it->second.value)
+			it = available.erase(it);
+		else
+			++it;
+	}
+}
+
+// function to check if a load would leave its register as it is, or a store its memory
+// ins	: the instruction
+bool Code_Generator::satisfied(Instruction& ins)
+{
+	if(ins.op != OP_LDA_CONST && ins.op != OP_LDX_CONST && ins.op != OP_LDY_CONST &&
+		ins.op != OP_LDA_MEM && ins.op != OP_LDX_MEM && ins.op != OP_LDY_MEM && ins.op != OP_STA) return false;
+	if(ins.host >= 0) return false; // the instruction is needed for the cell it keeps
+	vector<Content>& reg = holds[target(ins.op)]; // a store is satisfied if the accumulator already equals its memory
+	for(vector<Content>::iterator it = reg.begin(); it != reg.end(); ++it)
+	{
+		if(it->operand == ins.operand && it->value == ins.value)
+			return true;
+	}
+	return false;
+}
+
+// function to update what the registers are known to hold after an instruction
+// only straight-line code is followed - a label may be branched to, so nothing is known there
+// ins	: the instruction
+void Code_Generator::remember(Instruction& ins)
+{
+	switch(ins.op)
+	{
+		case OP_LABEL:
+		case OP_BRK:
+			holds[REG_A].clear();
+			holds[REG_X].clear();
+			holds[REG_Y].clear();
+			pending = -1;
+			break;
+		case OP_LDA_CONST:
+		case OP_LDX_CONST:
+		case OP_LDY_CONST:
+		case OP_LDA_MEM:
+		case OP_LDX_MEM:
+		case OP_LDY_MEM:
+			holds[target(ins.op)].assign(1, {ins.operand, ins.value});
+			if(target(ins.op) == REG_A) pending = -1;
+			break;
+		case OP_ADC:
+			holds[REG_A].clear();
+			pending = -1;
+			break;
+		case OP_INC:
+		case OP_STA:
+			// the memory changed, so only the accumulator still equals it after a store
+			for(int r = REG_A; r <= REG_Y; ++r)
 			{
-				generateCode(children.at(1), stringsMap); // recurse on <+>
-				// after recursing, the accumulator should contain the correct number to assign
-				// so all that needs to be done is to store the accumulator in memory
-				runtime_environment[codePointer] = 141; // 8d
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				addTemp(var, codePointer); // temp var
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				cpPP();
+				for(int i = holds[r].size()-1; i >= 0; --i)
+				{
+					if(holds[r][i].operand == ins.operand && holds[r][i].value == ins.value)
+						holds[r].erase(holds[r].begin()+i);
+				}
 			}
-		}
-		else if(type == "string")
-		{
-			AST_Node& var = children.at(0); // the variable
-			string key = children.at(1).name.substr(2, children.at(1).name.length()-4);
-			int addressOfString = stringsMap.at(key); // get the memory address of the string
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = addressOfString;
-			cpPP();
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			addTemp(var, codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-		}
-		else if(type == "boolean")
+			if(ins.op == OP_STA)
+				holds[REG_A].push_back({ins.operand, ins.value});
+			if(ins.operand == OPD_VAR)
+				declared.at(ins.value) = true; // a declaration of the slot after this can't start with its value in memory
+			if(ins.operand == OPD_VAR)
+				kill(ins.value); // what was computed from the variable, or kept in it, is out of date
+			// a <+> just computed is kept where it is first stored, unless it reads the variable it is stored in
+			if(ins.op == OP_STA && pending >= 0 &&
+				(ins.operand != OPD_VAR || key(pending).find("v" + to_string(ins.value) + ",") == string::npos))
+				available.emplace(key(pending), Content{ins.operand, ins.value});
+			break;
+		default: // compares, branches and system calls leave the registers alone
+			break;
+	}
+}
+
+// function to create a temporary cell, which is given an address when the code is assembled
+int Code_Generator::newCell()
+{
+	return numCells++;
+}
+
+// function to store the accumulator in a new temporary cell
+// the cell is the high address byte of the store instruction itself, so it costs no memory
+int Code_Generator::storeCell()
+{
+	int cell = newCell();
+	emit(OP_STA, OPD_CELL, cell, cell); // store into its own high address byte
+	return cell;
+}
+
+// function to compare the X register with the high address byte of the compare instruction itself, which is always 0
+void Code_Generator::compareZero()
+{
+	int zero = newCell();
+	emit(OP_CPX, OPD_CELL, zero, zero);
+}
+
+// function to create a label that is not yet bound to an address
+int Code_Generator::newLabel()
+{
+	return numLabels++;
+}
+
+// function to bind a label to the next instruction
+// label	: the label to bind
+void Code_Generator::bindLabel(int label)
+{
+	emit(OP_LABEL, OPD_LABEL, label);
+}
+
+// function to emit a branch to a label, leaving its displacement to the assembler
+// label	: the label to branch to
+void Code_Generator::branchTo(int label)
+{
+	emit(OP_BNE, OPD_LABEL, label);
+}
+
+// function to emit an unconditional jump to a label
+// there is no jump instruction, so X is loaded with 1 and compared with a byte that is always 0 before branching
+// label	: the label to jump to
+void Code_Generator::jump(int label)
+{
+	emit(OP_LDX_CONST, OPD_CONST, 1);
+	compareZero();
+	branchTo(label);
+}
+
+// function to branch to a label if a comparison is false, falling through if it is true
+// n		: index of the <==> or <!=> node
+// label	: the label to branch to
+void Code_Generator::branchIfFalse(int n, int label)
+{
+	if(AST[n].kind == N_EQUAL) // Z is 0 when the sides differ
+	{
+		branchTo(label);
+	}
+	else // <!=> - branch into the block when the sides differ and jump past it when they do not
+	{
+		int isTrue = newLabel();
+		branchTo(isTrue);
+		jump(label);
+		bindLabel(isTrue);
+	}
+}
+
+// function to get the size of an instruction in bytes
+// op	: the opcode of the instruction
+int Code_Generator::size(Opcode op)
+{
+	switch(op)
+	{
+		case OP_LABEL: // labels take no space
+			return 0;
+		case OP_NOP:
+		case OP_BRK:
+		case OP_SYS:
+			return 1;
+		case OP_LDA_CONST:
+		case OP_LDX_CONST:
+		case OP_LDY_CONST:
+		case OP_BNE:
+			return 2;
+		default: // instructions with a memory address
+			return 3;
+	}
+}
+
+// function to get the cycles an instruction takes, not counting the extra cycle of a taken branch
+// op	: the opcode of the instruction
+int Code_Generator::cycles(Opcode op)
+{
+	switch(op)
+	{
+		case OP_LABEL: // labels take no time
+			return 0;
+		case OP_LDA_CONST:
+		case OP_LDX_CONST:
+		case OP_LDY_CONST:
+		case OP_NOP:
+		case OP_BNE:
+			return 2;
+		case OP_SYS:
+		case OP_INC:
+			return 6;
+		case OP_BRK:
+			return 7;
+		default: // instructions with a memory address
+			return 4;
+	}
+}
+
+// function to apply the peephole patterns until none of them match
+// the code is walked from the top, tracking what the registers and memory are known to hold,
+// and every rewrite starts the walk over
+void Code_Generator::optimize()
+{
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		// nothing is known at the start of the program
+		known[REG_A] = known[REG_X] = known[REG_Y] = {OPD_NONE, 0};
+		memory.clear();
+		for(int i = 0; i < (int)code.size() && !changed; ++i) // for each instruction
 		{
-			AST_Node& var = children.at(0); // the variable
-			if(children.at(1).name == "[true]" || children.at(1).name == "[false]") // simply asssign true / false
+			for(vector<Peephole>::iterator p = peepholes.begin(); p != peepholes.end() && !changed; ++p) // for each pattern
 			{
-				int boolean = 0;
-				if(children.at(1).name == "[true]") boolean = 1; // set boolean to correct memory value
-				// load accumulator with constant
-				runtime_environment[codePointer] = 169; // a9
-				cpPP();
-				runtime_environment[codePointer] = boolean;
-				cpPP();
-				// store variable
-				runtime_environment[codePointer] = 141; // 8d
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				addTemp(var, codePointer); // temp var
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				cpPP();
-			}
-			else // right hand side of expression is <==> or <!=>
-			{
-				generateCode(children.at(1), stringsMap); // recurse on <==> or <!=>
-				// final value of a nested boolean expression will be stored in the last memory address
-				// load accumulator with the memory at this address
-				runtime_environment[codePointer] = 173; // ad
-				cpPP();
-				runtime_environment[codePointer] = codePointer-2; // address of last boolean push to memory
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				// store variable
-				runtime_environment[codePointer] = 141; // 8d
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				addTemp(var, codePointer); // temp var
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				cpPP();
+				// measure the code before trying the pattern
+				int bytes = 0;
+				int time = 0;
+				for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+				{
+					bytes += size(it->op);
+					time += cycles(it->op);
+				}
+				if((this->*(p->apply))(i)) // if the pattern matched, record what it saved
+				{
+					++p->matches;
+					for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+					{
+						bytes -= size(it->op);
+						time -= cycles(it->op);
+					}
+					p->bytes += bytes;
+					p->cycles += time;
+					changed = true;
+				}
 			}
+			if(!changed)
+				track(code[i]); // move past the instruction
 		}
 	}
-	else if(name == "<PrintStatement>")
+}
+
+// function to update what the registers and memory are known to hold after an instruction
+// ins	: the instruction
+void Code_Generator::track(Instruction& ins)
+{
+	switch(ins.op)
 	{
-		AST_Node& rhs = children.at(0);
-		if(rhs.name.length() == 3 && rhs.name.at(1) > 47 && rhs.name.at(1) < 58) // right hand digit
-		{
-			int num = rhs.name.at(1) - 48;
-			// load the x register with a constant representing "print value in y register"
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1; 
-			cpPP();
-			// load y register with a constant to print
-			runtime_environment[codePointer] = 160; // a0
-			cpPP();
-			runtime_environment[codePointer] = num; 
-			cpPP();
-		}
-		else if(rhs.name.length() == 3 && rhs.name.at(1) > 96 && rhs.name.at(1) < 123) // right hand id
-		{
-			// load the x register with correct constant for printing
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			if(rhs.type == "int" || rhs.type == "boolean") runtime_environment[codePointer] = 1; 
-			else if(rhs.type == "string") runtime_environment[codePointer] = 2;
-			cpPP();
-			// load y register with memory to print
-			runtime_environment[codePointer] = 172; // ac
-			cpPP();
-			runtime_environment[codePointer] = 0; 
-			addTemp(rhs, codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0; 
-			cpPP();
-		}
-		else if(rhs.name == "[true]" || rhs.name == "[false]")
-		{
-			string key = rhs.name.substr(1, rhs.name.length()-2); // true / false
-			int addressOfString = stringsMap.at(key); // get the memory address of the string
-			// load the x register with a constant representing "print string at address in y register"
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 2; 
-			cpPP();
-			// load y register with memory address of the string as a constant
-			runtime_environment[codePointer] = 160; // a0
-			cpPP();
-			runtime_environment[codePointer] = addressOfString; 
-			cpPP();
-		}
-		else if(rhs.name == "<+>")
+		case OP_LABEL: // a branch may land here, so nothing is known any more
+		case OP_BRK:
+			known[REG_A] = known[REG_X] = known[REG_Y] = {OPD_NONE, 0};
+			memory.clear();
+			break;
+		case OP_LDA_CONST:
+		case OP_LDX_CONST:
+		case OP_LDY_CONST:
+			known[target(ins.op)] = {ins.operand, ins.value};
+			break;
+		case OP_LDA_MEM:
+		case OP_LDX_MEM:
+		case OP_LDY_MEM:
+			known[target(ins.op)] = {OPD_NONE, 0}; // only constants are tracked
+			break;
+		case OP_ADC:
+			known[REG_A] = {OPD_NONE, 0};
+			break;
+		case OP_STA:
+			memory[make_pair(ins.operand, ins.value)] = known[REG_A];
+			break;
+		case OP_INC:
 		{
-			generateCode(rhs, stringsMap); // recurse on <+>
-			// after recursing, the accumulator should contain the correct number to assign
-			// so all that needs to be done is to print the accumulator in memory
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer+1; // store accumulator value at next address
-			cpPP();
-			runtime_environment[codePointer] = 0; // accumulator value will be stored here
-			cpPP();
-			// load the x register with a constant representing "print value in y register"
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1; 
-			cpPP();
-			// load y register with memory to print
-			runtime_environment[codePointer] = 172; // ac
-			cpPP();
-			runtime_environment[codePointer] = codePointer-4; // accumulator value should be stored there
-			cpPP();
-			runtime_environment[codePointer] = 0; 
-			cpPP();
+			Content& m = memory[make_pair(ins.operand, ins.value)];
+			if(m.operand == OPD_CONST)
+				m.value = (m.value + 1) % 256; // the byte wraps around
+			else
+				m = {OPD_NONE, 0};
+			break;
 		}
-		else if(rhs.name == "<==>" || rhs.name == "<!=>")
+		default: // compares, branches and system calls change no register or memory
+			break;
+	}
+}
+
+// function to print how much each peephole pattern saved
+void Code_Generator::printPeepholes()
+{
+	cout <<
+		"______________________________________________________________________" << endl <<
+		setw(24) << left << "" << "PEEPHOLE  OPTIMIZATIONS" << setw(23) << right << "" << endl <<
+		"______________________________________________________________________" << endl;
+	int bytes = 0; // total bytes saved
+	int time = 0; // total cycles saved
+	vector<Peephole> report = {skipped, preloaded, reused, hoisted}; // what was saved while generating comes first
+	report.insert(report.end(), peepholes.begin(), peepholes.end());
+	for(vector<Peephole>::iterator p = report.begin(); p != report.end(); ++p)
+	{
+		cout << "- " << p->name << ": " << p->matches << " match(es), "
+		<< p->bytes << " byte(s) and " << p->cycles << " cycle(s) saved" << endl;
+		bytes += p->bytes;
+		time += p->cycles;
+	}
+	cout << "- Total: " << bytes << " byte(s) and " << time << " cycle(s) saved" << endl;
+}
+
+// function to check if an instruction reads a register
+// op	: the opcode of the instruction
+// reg	: the register
+bool Code_Generator::reads(Opcode op, Register reg)
+{
+	switch(reg)
+	{
+		case REG_A: return op == OP_STA || op == OP_ADC;
+		case REG_X: return op == OP_CPX || op == OP_SYS;
+		case REG_Y: return op == OP_SYS;
+		default: return op == OP_BNE;
+	}
+}
+
+// function to check if an instruction writes a register
+// op	: the opcode of the instruction
+// reg	: the register
+bool Code_Generator::writes(Opcode op, Register reg)
+{
+	switch(reg)
+	{
+		case REG_A: return op == OP_LDA_CONST || op == OP_LDA_MEM || op == OP_ADC;
+		case REG_X: return op == OP_LDX_CONST || op == OP_LDX_MEM;
+		case REG_Y: return op == OP_LDY_CONST || op == OP_LDY_MEM;
+		default: return op == OP_CPX;
+	}
+}
+
+// function to check if a register may be read before it is next written, following every branch
+// i	: index of the instruction to start looking from
+// reg	: the register
+bool Code_Generator::live(int i, Register reg)
+{
+	vector<bool> seen(code.size(), false); // instructions already looked at
+	vector<int> paths(1, i); // where the paths left to follow start
+	while(!paths.empty())
+	{
+		int j = paths.back();
+		paths.pop_back();
+		for(; j < (int)code.size() && !seen[j]; ++j) // follow the path until it joins one already followed
 		{
-			generateCode(rhs, stringsMap); // recurse on <==> or <!=>
-			// final value of a nested boolean expression will be stored in the last memory address
-			// load y with the memory at this address
-			runtime_environment[codePointer] = 172; // ac
-			cpPP();
-			runtime_environment[codePointer] = codePointer-2; // address of last boolean push to memory
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// load x register with a constant representing "print value in y register"
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1; 
-			cpPP();
+			seen[j] = true;
+			if(reads(code[j].op, reg)) return true;
+			if(writes(code[j].op, reg) || code[j].op == OP_BRK) break;
+			if(code[j].op == OP_BNE) paths.push_back(labelIndex(code[j].value)); // the branch is a path too
 		}
-		else // string literal
+	}
+	return false;
+}
+
+// function to count the instructions referencing a cell (as an operand or a host) or a label
+// operand	: OPD_CELL or OPD_LABEL
+// value	: the cell or label
+int Code_Generator::references(Operand operand, int value)
+{
+	int count = 0;
+	for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+	{
+		if((it->operand == operand && it->value == value) || (operand == OPD_CELL && it->host == value))
+			++count;
+	}
+	return count;
+}
+
+// function to find the index of the instruction binding a label
+// label	: the label
+int Code_Generator::labelIndex(int label)
+{
+	for(int i = 0; i < (int)code.size(); ++i)
+	{
+		if(code[i].op == OP_LABEL && code[i].value == label)
+			return i;
+	}
+	return code.size();
+}
+
+// function to get the register a load instruction writes
+// op	: the opcode of the load
+Register Code_Generator::target(Opcode op)
+{
+	if(op == OP_LDX_CONST || op == OP_LDX_MEM) return REG_X;
+	if(op == OP_LDY_CONST || op == OP_LDY_MEM) return REG_Y;
+	return REG_A;
+}
+
+// pattern: STA m; LDA m - the accumulator still holds what was just stored
+// i	: index of the instruction to match at
+bool Code_Generator::storeReload(int i)
+{
+	if(i+1 >= (int)code.size() || code[i].op != OP_STA || code[i+1].op != OP_LDA_MEM) return false;
+	if(code[i].operand != code[i+1].operand || code[i].value != code[i+1].value || code[i+1].host >= 0) return false;
+	code.erase(code.begin()+i+1); // drop the load
+	return true;
+}
+
+// pattern: LDA m; STA m - the memory already holds what would be stored
+// i	: index of the instruction to match at
+bool Code_Generator::loadStore(int i)
+{
+	if(i+1 >= (int)code.size() || code[i].op != OP_LDA_MEM || code[i+1].op != OP_STA) return false;
+	if(code[i].operand != code[i+1].operand || code[i].value != code[i+1].value || code[i+1].host >= 0) return false;
+	code.erase(code.begin()+i+1); // drop the store
+	return true;
+}
+
+// pattern: LDr #k when r is known to hold k already
+// i	: index of the instruction to match at
+bool Code_Generator::knownLoad(int i)
+{
+	Instruction& ins = code[i];
+	if(ins.op != OP_LDA_CONST && ins.op != OP_LDX_CONST && ins.op != OP_LDY_CONST) return false;
+	Content& reg = known[target(ins.op)];
+	if(reg.operand != ins.operand || reg.value != ins.value) return false;
+	code.erase(code.begin()+i); // drop the load
+	return true;
+}
+
+// pattern: LDr m when m is known to hold a constant - load the constant instead
+// i	: index of the instruction to match at
+bool Code_Generator::constantMemory(int i)
+{
+	Instruction& ins = code[i];
+	if((ins.op != OP_LDA_MEM && ins.op != OP_LDX_MEM && ins.op != OP_LDY_MEM) || ins.host >= 0) return false;
+	map<pair<Operand, int>, Content>::iterator it = memory.find(make_pair(ins.operand, ins.value));
+	if(it == memory.end() || it->second.operand == OPD_NONE) return false;
+	if(ins.op == OP_LDA_MEM) ins.op = OP_LDA_CONST;
+	else if(ins.op == OP_LDX_MEM) ins.op = OP_LDX_CONST;
+	else ins.op = OP_LDY_CONST;
+	ins.operand = it->second.operand;
+	ins.value = it->second.value;
+	return true;
+}
+
+// pattern: CPX m when m is known to hold 0 - compare with the instruction's own high address byte instead
+// i	: index of the instruction to match at
+bool Code_Generator::compareKnownZero(int i)
+{
+	Instruction& ins = code[i];
+	if(ins.op != OP_CPX || ins.host >= 0) return false;
+	map<pair<Operand, int>, Content>::iterator it = memory.find(make_pair(ins.operand, ins.value));
+	if(it == memory.end() || it->second.operand != OPD_CONST || it->second.value != 0) return false;
+	int zero = newCell();
+	ins = {OP_CPX, OPD_CELL, zero, zero};
+	return true;
+}
+
+// pattern: STA c when nothing reads the cell - drop every store to it
+// i	: index of the instruction to match at
+bool Code_Generator::deadStore(int i)
+{
+	Instruction& ins = code[i];
+	if(ins.op != OP_STA || ins.operand != OPD_CELL || (ins.host >= 0 && ins.host != ins.value)) return false;
+	int cell = ins.value;
+	for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+	{
+		if(it->operand == OPD_CELL && it->value == cell && (it->op != OP_STA || (it->host >= 0 && it->host != cell)))
+			return false; // the cell is read, or a store to it hosts another cell
+	}
+	for(int j = code.size()-1; j >= 0; --j) // drop the stores
+	{
+		if(code[j].op == OP_STA && code[j].operand == OPD_CELL && code[j].value == cell)
+			code.erase(code.begin()+j);
+	}
+	return true;
+}
+
+// pattern: LDr when r is written again before anything reads it
+// i	: index of the instruction to match at
+bool Code_Generator::deadLoad(int i)
+{
+	Instruction& ins = code[i];
+	if(ins.op != OP_LDA_CONST && ins.op != OP_LDX_CONST && ins.op != OP_LDY_CONST &&
+		ins.op != OP_LDA_MEM && ins.op != OP_LDX_MEM && ins.op != OP_LDY_MEM) return false;
+	if(ins.host >= 0 || live(i+1, target(ins.op))) return false;
+	code.erase(code.begin()+i); // drop the load
+	return true;
+}
+
+// pattern: the boolean diamond of a comparison, which jumps over its false case with LDX #1; CPX zero; BNE
+//		CPX m; BNE F; LDA #t; LDX #1; CPX zero; BNE D; F: LDA #f; D:
+// becomes
+//		LDA #f; CPX m; BNE D; LDA #t; D:
+// since loading the accumulator leaves the Z flag alone
+// the LDA #t or LDX #1 is missing when the register already held a suitable constant
+// i	: index of the instruction to match at
+bool Code_Generator::foldDiamond(int i)
+{
+	int j = i+2; // index of the next instruction to match
+	if(j >= (int)code.size() || code[i].op != OP_CPX || code[i+1].op != OP_BNE) return false;
+	Instruction isTrue = {OP_LDA_CONST, known[REG_A].operand, known[REG_A].value, -1}; // the load of the true case
+	Content x = known[REG_X]; // what X holds at the jump (the compares and loads before it leave X alone)
+	if(code[j].op == OP_LDA_CONST)
+		isTrue = code[j++];
+	if(isTrue.operand != OPD_CONST) return false;
+	if(j < (int)code.size() && code[j].op == OP_LDX_CONST)
+		x = {code[j].operand, code[j++].value};
+	if(x.operand != OPD_CONST || x.value == 0) return false; // X must differ from the zero byte
+	if(j+4 >= (int)code.size()) return false;
+	Instruction* d = &code[j]; // the rest of the diamond
+	if(d[0].op != OP_CPX || d[0].operand != OPD_CELL || d[0].host != d[0].value || d[1].op != OP_BNE) return false;
+	if(d[2].op != OP_LABEL || d[2].value != code[i+1].value || d[3].op != OP_LDA_CONST) return false;
+	if(d[4].op != OP_LABEL || d[4].value != d[1].value) return false;
+	// the false label and zero byte must only be used here, and the X register and Z flag must not be read after
+	if(references(OPD_LABEL, code[i+1].value) != 2 || references(OPD_CELL, d[0].value) != 1) return false;
+	if(live(j+5, REG_X) || live(j+5, REG_Z)) return false;
+	Instruction folded[5] = {d[3], code[i], d[1], isTrue, d[4]};
+	code.erase(code.begin()+i, code.begin()+j+5);
+	code.insert(code.begin()+i, folded, folded+5);
+	return true;
+}
+
+// function to give every temporary cell stored inside a loop a scratch cell after the variables
+// a cell kept in the high address byte of its store turns the store's address into garbage the next time it runs,
+// so only cells stored once can stay there; the rest share scratch cells wherever their values are never live together
+void Code_Generator::allocateCells()
+{
+	int count = code.size();
+	// the instructions inside loops run from a label to the branch back to it
+	vector<bool> inLoop(count, false);
+	for(int i = 0; i < count; ++i)
+	{
+		if(code[i].op == OP_BNE)
 		{
-			string key = rhs.name.substr(2, rhs.name.length()-4);
-			int addressOfString = stringsMap.at(key); // get the memory address of the string
-			// load the x register with a constant representing "print string at address in y register"
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 2; 
-			cpPP();
-			// load y register with memory address of the string as a constant
-			runtime_environment[codePointer] = 160; // a0
-			cpPP();
-			runtime_environment[codePointer] = addressOfString; 
-			cpPP();
+			for(int j = labelIndex(code[i].value); j < i; ++j) // only backward branches make loops
+				inLoop[j] = true;
 		}
-		// print using system call
-		runtime_environment[codePointer] = 255;
-		cpPP();
 	}
-	else if(name == "<==>" || name == "<!=>")
+	scratch.assign(numCells, -1);
+	vector<bool> needed(numCells, false); // cells that need a scratch cell
+	for(int i = 0; i < count; ++i)
+	{
+		if(code[i].op == OP_STA && code[i].operand == OPD_CELL && inLoop[i])
+			needed[code[i].value] = true;
+	}
+
+	// liveness - the cells that may be read after each instruction before they are stored again
+	vector<vector<bool> > liveOut(count, vector<bool>(numCells, false));
+	bool changed = true;
+	while(changed)
 	{
-		AST_Node& left = children.at(0); // left hand side
-		int leftBool; // left hand stored bool compare value address
-		AST_Node& right = children.at(1); // right hand side
-		
-		// LEFT HAND SIDE
-		
-		if(left.name == "<==>" || left.name == "<!=>")
+		changed = false;
+		for(int i = count-1; i >= 0; --i) // backwards, so most facts settle in one pass
 		{
-			generateCode(left, stringsMap); // recurse on <==> or <!=>
-			leftBool = codePointer-1; // address of last boolean push to memory
+			vector<bool> out(numCells, false);
+			vector<int> next; // the instructions that can run next
+			if(code[i].op != OP_BRK && i+1 < count) next.push_back(i+1);
+			if(code[i].op == OP_BNE) next.push_back(labelIndex(code[i].value));
+			for(vector<int>::iterator n = next.begin(); n != next.end(); ++n)
+			{
+				if(*n >= count) continue;
+				Instruction& ins = code[*n];
+				for(int c = 0; c < numCells; ++c) // live into the next instruction
+				{
+					bool stored = ins.op == OP_STA && ins.operand == OPD_CELL && ins.value == c;
+					bool read = ins.op != OP_STA && ins.operand == OPD_CELL && ins.value == c;
+					if(read || (liveOut[*n][c] && !stored))
+						out[c] = true;
+				}
+			}
+			if(out != liveOut[i])
+			{
+				liveOut[i] = out;
+				changed = true;
+			}
 		}
-		else if(left.name.length() == 3 && left.name.at(1) > 47 && left.name.at(1) < 58) // left hand digit
+	}
+
+	// two cells interfere if one is stored while the other is live
+	vector<vector<bool> > interferes(numCells, vector<bool>(numCells, false));
+	for(int i = 0; i < count; ++i)
+	{
+		if(code[i].op != OP_STA || code[i].operand != OPD_CELL) continue;
+		int c = code[i].value;
+		for(int d = 0; d < numCells; ++d)
 		{
-			int num = left.name.at(1) - 48;
-			// load accumulator with constant
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = num;
-			cpPP();
-			// store accumulator in the unused memory address that is a part of the isntruction
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer + 1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // value will be stored here
-			revertTo0.push_back(codePointer); // to turn this memory back to 0
-			leftBool = codePointer; // this is where to eventually get the left variable
-			cpPP();
+			if(d != c && liveOut[i][d])
+				interferes[c][d] = interferes[d][c] = true;
 		}
-		else if(left.name.length() == 3 && left.name.at(1) > 96 && left.name.at(1) < 123) // left hand id
+	}
+
+	// give each cell the first scratch cell none of its interfering cells has
+	numScratch = 0;
+	for(int c = 0; c < numCells; ++c)
+	{
+		if(!needed[c]) continue;
+		int s = 0;
+		for(bool taken = true; taken; ++s)
 		{
-			// load accumulator from memory associated with the variabe
-			runtime_environment[codePointer] = 173; // ad
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			addTemp(left, codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// store accumulator in the unused memory address that is a part of the isntruction
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer + 1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // value will be stored here
-			revertTo0.push_back(codePointer); // to turn this memory back to 0
-			leftBool = codePointer; // this is where to eventually get the left variable
-			cpPP();
+			taken = false;
+			for(int d = 0; d < c; ++d)
+			{
+				if(interferes[c][d] && scratch[d] == s)
+					taken = true;
+			}
+			if(!taken) break;
 		}
-		else if(left.name == "[true]" || left.name == "[false]")
+		scratch[c] = s;
+		if(s >= numScratch) numScratch = s+1;
+	}
+	// the cells moved to scratch memory no longer live in their stores
+	for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+	{
+		if(it->host >= 0 && scratch[it->host] >= 0)
+			it->host = -1;
+	}
+}
+
+// function to encode the instructions into the runtime environment
+// the first pass lays out the code, labels and cells, the second fills in every byte
+void Code_Generator::assemble()
+{
+	vector<int> labels(numLabels, 0); // address each label is bound to
+	vector<int> cells(numCells, 0); // address of each temporary cell
+	// lay out the code
+	for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+	{
+		if(it->op == OP_LABEL)
+			labels.at(it->value) = codePointer;
+		if(it->host >= 0)
+			cells.at(it->host) = codePointer + 2; // the high address byte
+		codePointer += size(it->op);
+	}
+	// variables follow the code, one byte for each slot, and the scratch cells follow the variables
+	int variables = codePointer;
+	for(int s = 0; s < numSlots && variables + s <= stopPointer; ++s)
+		runtime_environment[variables + s] = initial[s]; // the value each variable starts with
+	codePointer += numSlots;
+	for(int c = 0; c < numCells; ++c)
+	{
+		if(scratch[c] >= 0)
+			cells.at(c) = codePointer + scratch[c];
+	}
+	codePointer += numScratch;
+	if(codePointer > stopPointer) // if we ran out of memory
+	{
+		codePointer = stopPointer; // prevent trying to access unreachable memory
+		if(numErrors < 1) // if we haven't yet reported this, do so
 		{
-			int boolean = 0;
-			if(left.name == "[true]") boolean = 1;
-			// load accumulator with constant
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = boolean; // true or false | 1 or 0
-			cpPP();
-			// store accumulator in the unused memory address that is a part of the isntruction
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer + 1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // value will be stored here
-			revertTo0.push_back(codePointer); // to turn this memory back to 0
-			leftBool = codePointer; // this is where to eventually get the left variable
-			cpPP();
+			cout << "[ERROR]" << ": (OOM) " << "The runtime environment is out of memory. Please limit your program to 256 bytes." << endl;
+			++numErrors; // increment the number of errors
 		}
-		else if(left.name == "<+>")
+	}
+	// encode the code
+	int address = 0; // address of the instruction being encoded
+	for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+	{
+		int operand = it->value;
+		switch(it->operand)
 		{
-			generateCode(left, stringsMap); // recurse on <+>
-			// after recursing, the accumulator should contain the correct number to compare
-			// so all that needs to be done is to store the accumulator in memory
-			// store accumulator in the unused memory address that is a part of the isntruction
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer + 1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // value will be stored here
-			revertTo0.push_back(codePointer); // to turn this memory back to 0
-			leftBool = codePointer; // this is where to eventually get the left variable
-			cpPP();
+			case OPD_STRING:
+				operand = stringAddresses.at(it->value);
+				break;
+			case OPD_VAR:
+				operand = variables + it->value;
+				break;
+			case OPD_CELL:
+				operand = cells.at(it->value);
+				break;
+			case OPD_LABEL:
+				// branches are relative to the next instruction and wrap around memory
+				operand = (labels.at(it->value) - (address+2) + 256) % 256;
+				break;
+			default:
+				break;
 		}
-		else // string literal 
+		int bytes[3] = {it->op, operand, 0}; // opcode, low byte, high byte
+		for(int i = 0; i < size(it->op); ++i, ++address)
 		{
-			string key = left.name.substr(2, left.name.length()-4);
-			int addressOfString = stringsMap.at(key); // get the memory address of the string
-			// load accumulator
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = addressOfString;
-			cpPP();
-			// store accumulator in the unused memory address that is a part of the isntruction
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer + 1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // value will be stored here
-			revertTo0.push_back(codePointer); // to turn this memory back to 0
-			leftBool = codePointer; // this is where to eventually get the left variable
-			cpPP();
+			if(address <= stopPointer) // never write over the string literals
+				runtime_environment[address] = bytes[i];
 		}
-		
-		// RIGHT HAND SIDE
-		if(right.name == "<==>" || right.name == "<!=>")
+	}
+}
+
+// function to compare both sides of a comparison, setting Z to 1 if they are equal
+// n	: index of the <==> or <!=> node
+void Code_Generator::compareSides(int n)
+{
+	int first = n+1; // index of the left hand side
+	int second = AST[first].end; // index of the right hand side
+	AST_Node& left = AST[first]; // left hand side
+	int leftBool; // cell holding the left hand side
+	AST_Node& right = AST[second]; // right hand side
+
+	// LEFT HAND SIDE
+
+	if(left.kind == N_EQUAL || left.kind == N_NOT_EQUAL)
+	{
+		generateCode(first); // recurse on <==> or <!=>
+		leftBool = result; // the left comparison already stored its result
+	}
+	else
+	{
+		// load the accumulator with the left hand side
+		if(left.kind == N_DIGIT) // left hand digit
+			emit(OP_LDA_CONST, OPD_CONST, left.value);
+		else if(left.kind == N_ID) // left hand id
+			emit(OP_LDA_MEM, OPD_VAR, left.slot);
+		else if(left.kind == N_TRUE || left.kind == N_FALSE)
+			emit(OP_LDA_CONST, OPD_CONST, (left.kind == N_TRUE) ? 1 : 0); // true or false | 1 or 0
+		else if(left.kind == N_ADD)
+			generateCode(first); // after recursing, the accumulator contains the number to compare
+		else // string literal
+			emit(OP_LDA_CONST, OPD_STRING, left.value);
+		// store accumulator in the unused memory address that is a part of the isntruction
+		leftBool = storeCell();
+	}
+
+	// RIGHT HAND SIDE
+	if(right.kind == N_EQUAL || right.kind == N_NOT_EQUAL)
+	{
+		generateCode(second); // recurse on <==> or <!=>
+		emit(OP_LDX_MEM, OPD_CELL, result); // load x from the result of the right comparison
+	}
+	else if(right.kind == N_DIGIT) // right hand digit
+	{
+		emit(OP_LDX_CONST, OPD_CONST, right.value);
+	}
+	else if(right.kind == N_ID) // right hand id
+	{
+		emit(OP_LDX_MEM, OPD_VAR, right.slot);
+	}
+	else if(right.kind == N_TRUE || right.kind == N_FALSE)
+	{
+		emit(OP_LDX_CONST, OPD_CONST, (right.kind == N_TRUE) ? 1 : 0); // true or false | 1 or 0
+	}
+	else if(right.kind == N_ADD)
+	{
+		generateCode(second); // recurse on <+>
+		// after recursing, the accumulator should contain the correct number to compare
+		// so store it in memory and put the stored value into the x register
+		int sum = storeCell();
+		emit(OP_LDX_MEM, OPD_CELL, sum);
+	}
+	else // string literal
+	{
+		emit(OP_LDX_CONST, OPD_STRING, right.value); // store address in x register
+	}
+
+	// COMPARE SIDES
+	// compare byte in memory to x register
+	emit(OP_CPX, OPD_CELL, leftBool);
+}
+
+// function to find the constant a <+> adds to a variable
+// n	: index of the <+> node
+// slot	: the slot of the variable
+// returns the sum of the digits if the <+> ends in the variable, or -1 if it doesn't
+int Code_Generator::increment(int n, int slot)
+{
+	int sum = 0;
+	while(AST[n].kind == N_ADD)
+	{
+		sum += AST[n+1].value; // the left side is always a digit
+		if(sum > 255) return -1; // leave the maximum value warning to the <+>
+		n = AST[n+1].end; // on to the right side
+	}
+	if(AST[n].kind == N_ID && AST[n].slot == slot)
+		return sum;
+	return -1;
+}
+
+// function to find the variable a counting loop counts with
+// a counting loop compares an int variable with a digit using <!=>, and its block increments the variable by a constant once
+// per iteration with no other assignment to it - the compare then needs no temporary cell and can sit at the bottom of the loop
+// n	: index of the while statement
+// returns the index of the variable in the condition, or -1 if the loop doesn't count
+int Code_Generator::counter(int n)
+{
+	int cond = n+1; // the condition
+	int block = AST[cond].end; // the block
+	if(AST[cond].kind != N_NOT_EQUAL) return -1;
+	int var = cond+1; // the variable, whichever side it is on
+	int digit = AST[var].end; // the digit
+	if(AST[var].kind == N_DIGIT) swap(var, digit);
+	if(AST[var].kind != N_ID || AST[var].type != TYPE_INT || AST[digit].kind != N_DIGIT) return -1;
+	int slot = AST[var].slot;
+	int increments = 0; // increments of the variable by the block's own statements
+	for(int c = block+1; c < AST[block].end; c = AST[c].end) // for each statement in the block
+	{
+		if(AST[c].kind == N_ASSIGNMENT_STATEMENT && AST[c+1].slot == slot && increment(AST[c+1].end, slot) >= 0)
+			++increments;
+	}
+	int assignments = 0; // assignments to the variable anywhere in the block, however deeply nested
+	for(int i = block; i < AST[block].end; ++i)
+	{
+		if(AST[i].kind == N_ASSIGNMENT_STATEMENT && AST[i+1].slot == slot)
+			++assignments;
+	}
+	return (increments == 1 && assignments == 1) ? var : -1;
+}
+
+// function to lower the AST to instructions
+// n	: index of the node in the abstract syntax tree being used
+void Code_Generator::generateCode(int n)
+{
+	// variables
+	AST_Node& ast = AST[n];
+	Type type = ast.type;
+	int first = n+1; // index of the first child, which directly follows its parent
+	int second = (ast.numChildren > 1) ? AST[first].end : first; // index of the second child, which follows the first child's subtree
+
+	switch(ast.kind)
+	{
+		case N_BLOCK:
 		{
-			generateCode(right, stringsMap); // recurse on <==> or <!=>
-			// load x from memory
-			runtime_environment[codePointer] = 174; // ae
-			cpPP();
-			runtime_environment[codePointer] = codePointer-2; // address of last boolean push to memory
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
+			// recurse on child nodes
+			for(int c = first; c < ast.end; c = AST[c].end) // for each child node
+				generateCode(c); // recurse
+			break;
 		}
-		else if(right.name.length() == 3 && right.name.at(1) > 47 && right.name.at(1) < 58) // right hand digit
+		case N_VAR_DECL:
 		{
-			int num = right.name.at(1) - 48;
-			// load x with constant
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = num;
-			cpPP();
+			AST_Node& var = AST[second]; // the variable
+			// set the memoy address of uninitialzed variables to 0 if not a string (reference type), or the last byte for strings (empty string)
+			int start = (var.type == TYPE_STRING) ? 255 : 0;
+			// declarations the dead store eliminator kept can be read before they are assigned,
+			// but one outside any loop, before anything has stored to its slot (a variable whose declaration was removed
+			// may have shared it), runs once before anything else does, so its byte can simply start with the value
+			bool fresh = !declared.at(var.slot);
+			declared.at(var.slot) = true;
+			if(loops == 0 && fresh)
+			{
+				initial.at(var.slot) = start;
+				++preloaded.matches;
+				preloaded.bytes += size(OP_LDA_CONST) + size(OP_STA);
+				preloaded.cycles += cycles(OP_LDA_CONST) + cycles(OP_STA);
+				return;
+			}
+			emit(OP_LDA_CONST, OPD_CONST, start);
+			emit(OP_STA, OPD_VAR, var.slot);
+			return;
 		}
-		else if(right.name.length() == 3 && right.name.at(1) > 96 && right.name.at(1) < 123) // right hand id
+		case N_ASSIGNMENT_STATEMENT:
 		{
-			// load x from memory
-			runtime_environment[codePointer] = 174; // ae
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			addTemp(right, codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
+			AST_Node& var = AST[first]; // the variable to assign
+			AST_Node& rhs = AST[second]; // the value assigned
+			if(rhs.kind == N_ID) // if the assignment is one variable to another
+			{
+				emit(OP_LDA_MEM, OPD_VAR, rhs.slot); // load variable to give value
+			}
+			else if(type == TYPE_INT)
+			{
+				int k = increment(second, var.slot);
+				if(rhs.kind == N_DIGIT) // if the assignment is simply a digit
+				{
+					emit(OP_LDA_CONST, OPD_CONST, rhs.value);
+				}
+				else if(k >= 0 && k <= 2) // x = k + x
+				{
+					// k INC instructions (3 bytes and 6 cycles each) are smaller than LDA #k; ADC x; STA x (8 bytes and 10 cycles)
+					for(int i = 0; i < k; ++i)
+						emit(OP_INC, OPD_VAR, var.slot);
+					break;
+				}
+				else // assignment had a <+> in it
+					generateCode(second); // after recursing, the accumulator contains the number to assign
+			}
+			else if(type == TYPE_STRING)
+			{
+				emit(OP_LDA_CONST, OPD_STRING, rhs.value); // the memory address of the string
+			}
+			else if(type == TYPE_BOOLEAN)
+			{
+				if(rhs.kind == N_TRUE || rhs.kind == N_FALSE) // simply asssign true / false
+				{
+					emit(OP_LDA_CONST, OPD_CONST, (rhs.kind == N_TRUE) ? 1 : 0);
+				}
+				else // right hand side of expression is <==> or <!=>
+				{
+					generateCode(second); // recurse on <==> or <!=>
+					emit(OP_LDA_MEM, OPD_CELL, result); // load the result of the comparison
+				}
+			}
+			else break;
+			// store variable to get value
+			emit(OP_STA, OPD_VAR, var.slot);
+			break;
 		}
-		else if(right.name == "[true]" || right.name == "[false]")
+		case N_PRINT_STATEMENT:
 		{
-			int boolean = 0;
-			if(right.name == "[true]") boolean = 1;
-			// load x with constant
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = boolean; // true or false | 1 or 0
-			cpPP();
+			AST_Node& rhs = AST[first];
+			if(rhs.kind == N_DIGIT) // right hand digit
+			{
+				// load the x register with a constant representing "print value in y register"
+				emit(OP_LDX_CONST, OPD_CONST, 1);
+				// load y register with a constant to print
+				emit(OP_LDY_CONST, OPD_CONST, rhs.value);
+			}
+			else if(rhs.kind == N_ID) // right hand id
+			{
+				// load the x register with correct constant for printing
+				emit(OP_LDX_CONST, OPD_CONST, (rhs.type == TYPE_STRING) ? 2 : 1);
+				// load y register with memory to print
+				emit(OP_LDY_MEM, OPD_VAR, rhs.slot);
+			}
+			else if(rhs.kind == N_TRUE || rhs.kind == N_FALSE)
+			{
+				// load the x register with a constant representing "print string at address in y register"
+				emit(OP_LDX_CONST, OPD_CONST, 2);
+				// load y register with memory address of the string as a constant
+				emit(OP_LDY_CONST, OPD_STRING, (rhs.kind == N_TRUE) ? trueString : falseString);
+			}
+			else if(rhs.kind == N_ADD)
+			{
+				generateCode(first); // recurse on <+>
+				// after recursing, the accumulator should contain the correct number to print
+				// so store it in memory where the y register can be loaded from
+				int sum = storeCell();
+				// load the x register with a constant representing "print value in y register"
+				emit(OP_LDX_CONST, OPD_CONST, 1);
+				// load y register with memory to print
+				emit(OP_LDY_MEM, OPD_CELL, sum);
+			}
+			else if(rhs.kind == N_EQUAL || rhs.kind == N_NOT_EQUAL)
+			{
+				generateCode(first); // recurse on <==> or <!=>
+				// load y with the result of the comparison
+				emit(OP_LDY_MEM, OPD_CELL, result);
+				// load x register with a constant representing "print value in y register"
+				emit(OP_LDX_CONST, OPD_CONST, 1);
+			}
+			else // string literal
+			{
+				// load the x register with a constant representing "print string at address in y register"
+				emit(OP_LDX_CONST, OPD_CONST, 2);
+				// load y register with memory address of the string as a constant
+				emit(OP_LDY_CONST, OPD_STRING, rhs.value);
+			}
+			// print using system call
+			emit(OP_SYS);
+			break;
 		}
-		else if(right.name == "<+>")
+		case N_EQUAL:
+		case N_NOT_EQUAL:
 		{
-			generateCode(right, stringsMap); // recurse on <+>
-			// after recursing, the accumulator should contain the correct number to compare
-			// so all that needs to be done is to store the accumulator in memory
+			if(reuse(n)) break; // the same comparison already stored its result
+			int from = code.size(); // the first instruction of the comparison
+			compareSides(n); // Z is 1 if the sides are equal
+			int isFalse = newLabel(); // where the z flag is 0
+			int done = newLabel(); // where both cases meet
+			branchTo(isFalse);
+			// true (z flag is 1) - load accumulator with constant 1 for <==> or 0 for <!=>
+			emit(OP_LDA_CONST, OPD_CONST, (ast.kind == N_EQUAL) ? 1 : 0);
+			// jump past what comes next (false section)
+			jump(done);
+			// false (z flag is 0) - load accumulator with constant 0 for <==> or 1 for <!=>
+			bindLabel(isFalse);
+			emit(OP_LDA_CONST, OPD_CONST, (ast.kind == N_EQUAL) ? 0 : 1);
+			bindLabel(done);
 			// store accumulator in the unused memory address that is a part of the isntruction
-			runtime_environment[codePointer] = 141; // 8d
-			cpPP();
-			runtime_environment[codePointer] = codePointer + 1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // value will be stored here
-			revertTo0.push_back(codePointer); // to turn this memory back to 0
-			cpPP();
-			// now we need to put the stored value into x register
-			runtime_environment[codePointer] = 174; // ae
-			cpPP();
-			runtime_environment[codePointer] = codePointer - 2; // get stored value and put into x
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-		}
-		else // string literal 
-		{
-			string key = right.name.substr(2, children.at(1).name.length()-4);
-			int addressOfString = stringsMap.at(key); // get the memory address of the string
-			// store address in x register
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = addressOfString;
-			cpPP();
+			result = storeCell();
+			computed(n, from);
+			if(reusable(n))
+				available.emplace(key(n), Content{OPD_CELL, result});
+			break;
 		}
-		
-		// COMPARE SIDES
-		// compare byte in memory to x register
-		runtime_environment[codePointer] = 236; // ec
-		cpPP();
-		runtime_environment[codePointer] = leftBool; // memory address of left
-		cpPP();
-		runtime_environment[codePointer] = 0;
-		cpPP();
-		// branch 9 bytes if not equal
-		runtime_environment[codePointer] = 208; //d0
-		cpPP();
-		runtime_environment[codePointer] = 9; // 9 bytes
-		cpPP();
-		if(name == "<==>")
+		case N_ADD:
 		{
-			// true (z flag is 1) - load accumulator with constant 1
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = 1;
-			cpPP();
-			// jump past what comes next (false section)
-			//		set X register to 2, compare it to memory address
-			//		255, which is always 0, and branch
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1;
-			cpPP();
-			runtime_environment[codePointer] = 236; // ec
-			cpPP();
-			runtime_environment[codePointer] = codePointer+1; // contains 0
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			runtime_environment[codePointer] = 208; // branch
-			cpPP();
-			runtime_environment[codePointer] = 2; // 2 bytes to skip next section
-			cpPP();
-			// false (z flag is 0) - load accumulator with constant 0
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
+			bool root = value == 0; // the whole <+>, not the rest of one
+			if(root && reuse(n)) break; // the same <+> was already computed
+			int from = code.size(); // the first instruction of the <+>
+			if(AST[second].kind == N_ID) // seocnd child is id and not <+>
+			{
+				value += AST[first].value; // add left digit
+				if(value > 255) // passed max int value
+				{
+					cout << "[WARN]Line " << ast.lineNum << ": " << "The maximum value of an integer is 255. Compilation will continue with the max." << endl;
+					++numWarn;
+					value = 255;
+				}
+				// load accumulator with the constant value and add the variable's value to it
+				// do not store the accumulator in memory
+				emit(OP_LDA_CONST, OPD_CONST, value);
+				emit(OP_ADC, OPD_VAR, AST[second].slot);
+				value = 0; // reset value
+			}
+			else if(AST[second].kind == N_DIGIT) // seocnd child is a digit and not <+>
+			{
+				int num = AST[second].value;
+				num += AST[first].value; // add left digit
+				value += num; // add to the value
+				if(value > 255) // passed max int value
+				{
+					cout << "[WARN]Line " << ast.lineNum << ": " << "The maximum value of an integer is 255. Compilation will continue with the max." << endl;
+					++numWarn;
+					value = 255;
+				}
+				// load accumulator with the constant value
+				// do not store the accumulator in memory
+				emit(OP_LDA_CONST, OPD_CONST, value);
+				value = 0; // reset value
+			}
+			else // second child is <+>
+			{
+				value += AST[first].value; // add left digit
+				generateCode(second); // recurse on <+>
+			}
+			if(root && reusable(n))
+			{
+				computed(n, from);
+				pending = n; // kept wherever the caller stores it
+			}
+			break;
 		}
-		else if(name == "<!=>")
+		case N_IF_STATEMENT:
 		{
-			// true (z flag is 1) - load accumulator with constant 0
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// jump past what comes next (false section)
-			//		set X register to 2, compare it to memory address
-			//		255, which is always 0, and branch
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1;
-			cpPP();
-			runtime_environment[codePointer] = 236; // ec
-			cpPP();
-			runtime_environment[codePointer] = codePointer+1; // contains 0
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			runtime_environment[codePointer] = 208; // branch
-			cpPP();
-			runtime_environment[codePointer] = 2; // 2 bytes to skip next section
-			cpPP();
-			// false (z flag is 0) - load accumulator with constant 1
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = 1;
-			cpPP();
+			// the constant folder has already dropped or inlined the if statements on [false] or [true], so this is <==> or <!=>
+			// branch past the <block> if false, straight from the comparison
+			int skip = newLabel();
+			compareSides(first);
+			branchIfFalse(first, skip);
+			// evaluate the <block>, keeping only what is computed before it for after it, since it may be skipped
+			map<string, Content> before = available;
+			generateCode(second);
+			meet(before);
+			bindLabel(skip);
+			break;
 		}
-		// store accumulator in the unused memory address that is a part of the isntruction
-		runtime_environment[codePointer] = 141; // 8d
-		cpPP();
-		runtime_environment[codePointer] = codePointer + 1;
-		cpPP();
-		runtime_environment[codePointer] = 0; // value will be stored here
-		revertTo0.push_back(codePointer); // to turn this memory back to 0
-		cpPP();
-	}
-	else if(name == "<+>")
-	{
-		if(children.at(1).name.at(1) > 96 && children.at(1).name.at(1) < 123) // seocnd child is id and not <+>
+		case N_WHILE_STATEMENT:
 		{
-			value += children.at(0).name.at(1) - 48; // add left digit
-			if(value > 255) // passed max int value
+			++loops; // the declarations in the loop may run more than once
+			// what the loop assigns may have changed by the time it comes back around
+			killLoop(n);
+			preheader(n);
+			int start = code.size(); // the first instruction of the loop
+			map<string, Content> before = available;
+			AST_Node& conditional = AST[first];
+			// the constant folder has already dropped the loops on [false]
+			if(conditional.kind == N_TRUE)
 			{
-				cout << "[WARN]Line " << ast.lineNum << ": " << "The maximum value of an integer is 255. Compilation will continue with the max." << endl;
+				cout << "[WARN]Line " << conditional.lineNum << ": " << "This language has no method of breaking from an iteration that loops on [true]." << endl;
 				++numWarn;
-				value = 255;
+				int loop = newLabel();
+				bindLabel(loop); // loop back to here
+				generateCode(second);
+				// jump all the way around
+				jump(loop);
 			}
-			// load accumulator with the constant value and add the variable's value to it
-			// do not store the accumulator in memory
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = value;
-			cpPP();
-			runtime_environment[codePointer] = 109; // 6d
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			addTemp(children.at(1), codePointer); // temp var
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			value = 0; // reset value
-		}
-		else if(children.at(1).name.at(1) > 47 && children.at(1).name.at(1) < 58) // seocnd child is a digit and not <+>
-		{
-			int num = children.at(1).name.at(1) - 48;
-			num += children.at(0).name.at(1) - 48; // add left digit
-			value += num; // add to the value
-			if(value > 255) // passed max int value
+			else if(conditional.kind == N_NOT_EQUAL) // rotated, so the test at the bottom branches straight back
 			{
-				cout << "[WARN]Line " << ast.lineNum << ": " << "The maximum value of an integer is 255. Compilation will continue with the max." << endl;
-				++numWarn;
-				value = 255;
+				int loop = newLabel();
+				int test = newLabel();
+				// the test sits at the bottom of the loop, so jump down to it the first time
+				jump(test);
+				bindLabel(loop); // loop back to here
+				generateCode(second);
+				// evaluate conditional
+				bindLabel(test);
+				int var = counter(n);
+				if(var >= 0) // a counting loop - compare the counter in memory with the digit in the x register
+				{
+					int digit = (var == first+1) ? AST[var].end : first+1; // the other side of the <!=>
+					emit(OP_LDX_CONST, OPD_CONST, AST[digit].value);
+					emit(OP_CPX, OPD_VAR, AST[var].slot);
+				}
+				else
+				{
+					compareSides(first);
+				}
+				// loop while the sides differ
+				branchTo(loop);
 			}
-			// load accumulator with the constant value
-			// do not store the accumulator in memory
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = value;
-			cpPP();
-			value = 0; // reset value
-		}
-		else // second child is <+>
-		{
-			value += children.at(0).name.at(1) - 48; // add left digit
-			generateCode(children.at(1), stringsMap); // recurse on <+>
-		}
-	}
-	else if(name == "<IfStatement>")
-	{
-		AST_Node& conditional = children.at(0);
-		AST_Node& then = children.at(1);
-		if(conditional.name == "[false]")
-		{
-			cout << "[WARN]Line " << conditional.lineNum << ": " << "This for statement will never be executed." << endl;
-			++numWarn;
-		}
-		else if(conditional.name == "[true]")
-		{
-			generateCode(then ,stringsMap); // we know it will evaluate so just compute the then part
-		}
-		else // <==> or <!=>
-		{
-			generateCode(conditional, stringsMap);
-			// final value of a nested boolean expression will be stored in the last memory address
-			// load the x register with a constant representing true
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1; // true
-			cpPP();
-			// compare x register with memory holding result of boolean expression
-			runtime_environment[codePointer] = 236; // ec
-			cpPP();
-			runtime_environment[codePointer] = codePointer-4;
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// branch n bytes if false
-			runtime_environment[codePointer] = 208; // d0
-			cpPP();
-			runtime_environment[codePointer] = -1; // n starts at -1 so its own call to cpPP() isn't counted
-			jumps.push_back(codePointer); // add this memory address to jump modifying queue
-			cpPP();
-			// evaluate the <block>
-			generateCode(then, stringsMap);
-			jumps.pop_back(); // remove the jump address from modifying queue
-		}
-	}
-	else if(name == "<WhileStatement>")
-	{
-		AST_Node& conditional = children.at(0);
-		AST_Node& then = children.at(1);
-		if(conditional.name == "[false]")
-		{
-			cout << "[WARN]Line " << conditional.lineNum << ": " << "This loop will never be executed." << endl;
-			++numWarn;
-		}
-		else if(conditional.name == "[true]")
-		{
-			cout << "[WARN]Line " << conditional.lineNum << ": " << "This language has no method of breaking from an iteration that loops on [true]." << endl;
-			++numWarn;
-			int savedAddress = codePointer; // save memory address to loop
-			generateCode(then, stringsMap);
-			// load accumulator with a 0
-			runtime_environment[codePointer] = 169; // a9
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// store accumulator in unused memory address of instruction
-			runtime_environment[codePointer] = 141;
-			cpPP();
-			runtime_environment[codePointer] = codePointer+1;
-			cpPP();
-			runtime_environment[codePointer] = 0; // accumulator will be stored here
-			cpPP();
-			// load the x register with a constant representing true
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1; // true
-			cpPP();
-			// compare x with 0
-			runtime_environment[codePointer] = 236; // ec
-			cpPP();
-			runtime_environment[codePointer] = codePointer-4;
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// branch all the way around
-			runtime_environment[codePointer] = 208; // d0
-			cpPP();
-			runtime_environment[codePointer] = 255 - (codePointer-savedAddress);
-			cpPP();
-		}
-		else // <==> or <!=>
-		{
-			int loopStart = codePointer;
-			// evaluate conditional
-			cout << "loop start: " << loopStart << endl;
-			generateCode(conditional, stringsMap);
-			// final value of a nested boolean expression will be stored in the last memory address
-			// load the x register with a constant representing true
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1; // true
-			cpPP();
-			// compare x register with memory holding result of boolean expression
-			runtime_environment[codePointer] = 236; // ec
-			cpPP();
-			runtime_environment[codePointer] = codePointer-4;
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			int saved0Val = codePointer;
-			cpPP();
-			
-			//////////////////// Code Band-Aid //////////////////////////////////////////////////
-			// revert necessary memory addresses back to 0 so we don't get memory errors
-			for(vector<int>::iterator it = revertTo0.begin() ; it != revertTo0.end(); ++it)
+			else // <==> - there is no branch if equal, so the test stays at the top
 			{
-				// load accumulator 
-				runtime_environment[codePointer] = 169; // a9
-				cpPP();
-				runtime_environment[codePointer] = 0; // going to set them all to 0
-				cpPP();
-				// store accumulator
-				runtime_environment[codePointer] = 141; // 8d
-				cpPP();
-				runtime_environment[codePointer] = *it;
-				cpPP();
-				runtime_environment[codePointer] = 0;
-				cpPP();
+				int loop = newLabel();
+				int exit = newLabel();
+				bindLabel(loop); // loop back to here
+				// evaluate conditional
+				compareSides(first);
+				// leave the loop if false
+				branchIfFalse(first, exit);
+				// evaluate the <block>
+				generateCode(second);
+				// loop - jump all the way to beginning of loop
+				jump(loop);
+				bindLabel(exit);
 			}
-			//////////////////// Code Band-Aid //////////////////////////////////////////////////
-			
-			// branch n bytes if false
-			runtime_environment[codePointer] = 208; // d0
-			cpPP();
-			runtime_environment[codePointer] = -1; // n starts at -1
-			jumps.push_back(codePointer); // add this memory address to jump modifying queue
-			cpPP();
-			// evaluate the <block>
-			generateCode(then, stringsMap);
-			//int loopBranch = 256 - runtime_environment[jumps.back()]; // how much to loop around
-			//int loopBranch = 255 - (256 - loopStart); // loop all the way around to the conditional
-			//cout << "loopBranch: " << loopBranch << endl;
-			//jumps.pop_back(); // remove the jump address from modifying queue
-			// load x register with a 1
-			runtime_environment[codePointer] = 162; // a2
-			cpPP();
-			runtime_environment[codePointer] = 1;
-			cpPP();
-			// compare x register with memory holding 0 so loop around always happens
-			runtime_environment[codePointer] = 236; // ec
-			cpPP();
-			runtime_environment[codePointer] = saved0Val; // this memory definitely contains a 0
-			cpPP();
-			runtime_environment[codePointer] = 0;
-			cpPP();
-			// loop - branch all the way to beginning of loop
-			runtime_environment[codePointer] = 208; // d0
-			cpPP();
-			//int loopBranch = ((256-codePointer)+loopStart);
-			int loopBranch = 255 - (codePointer-loopStart);
-			runtime_environment[codePointer] = loopBranch; // loop around
-			cout << "curaddress: " << codePointer << endl;
-			cout << "loopBranch: " << loopBranch << endl;
-			cpPP();
-			jumps.pop_back(); // remove the jump address from modifying queue
+			meet(before); // what the loop computes might not be computed before it exits
+			hoist(start);
+			--loops;
+			break;
 		}
+		default:
+			break;
 	}
-	/*
-	else if(name.length() == 3 && name.at(1) > 47 && name.at(1) < 58) // [0-9]
-	{
-		int num = name.at(1) - 48;
-		value += num; // add to the value
-		return;
-	}
-	*/
-	
-	
 }
 
-// function to add all necessary temporary variables to the temporary variable table
-// ast	: the abstract syntax tree to get the variables from
-void Code_Generator::addTemps(AST_Node& ast)
+// function to count the variable slots that need memory
+// every declared variable has a dense slot, so memory is needed for one byte per slot
+void Code_Generator::countSlots()
 {
-	vector<AST_Node>& children = *ast.children; // child nodes
-	if(ast.name.length() == 3 && ast.name.at(1) > 96 && ast.name.at(1) < 123) // if this is an id
+	numSlots = 0; // the number of slots in use
+	for(vector<AST_Node>::iterator it = AST.begin(); it != AST.end(); ++it) // for each node
 	{
-		stringstream keyStream;
-		keyStream << ast.name.at(1) << "@" << ast.scope << "-" << ast.subscope;
-		string key = keyStream.str();
-		Temp_Var* tmp = new Temp_Var;
-		tempTable.emplace(key, *tmp);
+		if(it->kind == N_ID && it->slot >= numSlots)
+			numSlots = it->slot + 1;
 	}
-	// recurse on child nodes
-	for(vector<AST_Node>::iterator it=children.begin(); it != children.end(); ++it) // for each child node
-		addTemps(*it); // recurse
+	initial.assign(numSlots, 0); // the runtime environment starts with 00s
+	declared.assign(numSlots, false);
 }
 
-// function to add all string literals to the runtime environment and store their memory addresses
-// stringsMap	: the map containing all the strings
+// function to pack the string literals the instructions use into the runtime environment and store their memory addresses
+// a string ending another one already in memory points into it, sharing its characters and end-of-string character
+// stringsMap	: the map containing all the strings, each mapped to its index
 void Code_Generator::addStrings(unordered_map<string, int>& stringsMap)
 {
-	// add in the string literals "true" and "false" for booleans (if they don't already exist)
-	stringsMap.emplace("true", 0);
-	stringsMap.emplace("false", 0);
+	stringAddresses.resize(stringsMap.size(), 0);
+	// byte 255 is the empty string that string variables start with, kept apart from the literals so they never compare equal
+	--stopPointer;
+	// only the strings some instruction still loads need memory
+	vector<bool> used(stringsMap.size(), false);
+	for(vector<Instruction>::iterator it = code.begin(); it != code.end(); ++it)
+	{
+		if(it->operand == OPD_STRING)
+			used.at(it->value) = true;
+	}
+	vector<string> strings; // the strings to lay out
+	for(auto it = stringsMap.begin(); it != stringsMap.end(); ++it)
+	{
+		if(used.at(it->second))
+			strings.push_back(it->first);
+	}
+	// longest first, so every string that can share is laid out after the one it ends
+	sort(strings.begin(), strings.end(), [](const string& a, const string& b)
+	{
+		return (a.length() != b.length()) ? a.length() > b.length() : a < b;
+	});
 	// new stringsMap
 	unordered_map<string, int> newMap;
-	// for each string in the map
-	for(auto it = stringsMap.begin(); it != stringsMap.end(); ++it)
+	// for each string used
+	for(vector<string>::iterator it = strings.begin(); it != strings.end(); ++it)
 	{
-		string str = it->first;
-		runtime_environment[stopPointer] = 0; // set the end-of-string character
-		--stopPointer; // decrement the stopPointer
-		// for each character in the string
-		for(int i = str.length(); i > 0; --i)
+		string str = *it;
+		int address = -1; // where the string starts
+		for(vector<string>::iterator longer = strings.begin(); longer != it && address < 0; ++longer) // a string it ends
 		{
-			if(stopPointer <= codePointer) // if we have run out of memory
+			int offset = longer->length() - str.length();
+			if(longer->compare(offset, str.length(), str) == 0)
+				address = newMap.at(*longer) + offset;
+		}
+		if(address < 0) // no string to share, so lay it out below the others
+		{
+			runtime_environment[stopPointer] = 0; // set the end-of-string character
+			--stopPointer; // decrement the stopPointer
+			// for each character in the string
+			for(int i = str.length(); i > 0; --i)
 			{
-				// report error and return
-				cout << "[ERROR]" << ": (OOM) " << "The runtime environment is out of memory. Please limit your program to 256 bytes." << endl;
-				++numErrors;
-				return;
+				if(stopPointer <= codePointer) // if we have run out of memory
+				{
+					// report error and return
+					cout << "[ERROR]" << ": (OOM) " << "The runtime environment is out of memory. Please limit your program to 256 bytes." << endl;
+					++numErrors;
+					return;
+				}
+				runtime_environment[stopPointer] = str.at(i-1); // set the character in memory
+				--stopPointer; // decrement stop pointer
 			}
-			runtime_environment[stopPointer] = str.at(i-1); // set the character in memory
-			--stopPointer; // decrement stop pointer
+			address = stopPointer+1;
 		}
 		// add string to the new map with memory address of string
-		newMap.emplace(str, stopPointer+1);
+		newMap.emplace(str, address);
+		stringAddresses.at(stringsMap.at(str)) = address; // the string's index now leads to its address too
 	}
 	// update stringsMap
 	stringsMap = newMap;
@@ -1013,6 +1707,10 @@ void Code_Generator::hexTrace()
 			case 0: // 00
 				// cout << "Break" << endl;
 				break;
+			case 238: // EE
+				cout << "- Increment the value in memory @ " << runtime_environment[++i] << endl;
+				++i;
+				break;
 			case 236: // EC
 				cout << "- Set Z = 1 if X = memory @ " << runtime_environment[++i] << endl;
 				++i;
@@ -12,14 +12,26 @@ CMPT 432 - DESIGN OF COMPILERS
 #include <regex>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
 #include <queue>
+#include <map>
 #include <unordered_map>
 #include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include <memory>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
 
 #include "lexer.h" 	// The Lexer
 #include "parser.h"	// The Parser
 #include "semantic_analyzer.h" // The Semantic Analyzer
+#include "constant_folder.h" // The Constant Folder
+#include "evaluator.h" // The Evaluator
+#include "dead_store_eliminator.h" // The Dead Store Eliminator
 #include "code_generator.h" // The Code Generator
+#include "incremental.h" // The Incremental Session
 
 using namespace std;
 using std::string;
@@ -34,13 +46,31 @@ int main(int argc, char *argv[])
 	string fileName; // variable to store the source program filepath
 	ifstream sourceFile; // variable to store the filestream
 	bool verbose = false; // true if verbose output should occur
+	bool incremental = false; // true if edits should be read and recompiled incrementally
+	bool evaluate = false; // true if a program that finishes at compile time should be replaced by its output
+	int budget = 100000; // the most steps compile-time evaluation may take, with or without "evaluate"
 	if(argc > 1) // if the user entered a program filepath for compiling
 	{
 		fileName = argv[1]; // set the source variable to that program filepath
-		if(argc > 2)
+		for(int i = 2; i < argc; ++i)
 		{
-			string arg = argv[2];
+			string arg = argv[i];
 			if(arg == "verbose") verbose = true;
+			if(arg == "incremental") incremental = true;
+			if(arg == "evaluate") evaluate = true;
+			if(arg.compare(0, 9, "evaluate=") == 0)
+			{
+				char* end; // just past the digits of the budget
+				errno = 0;
+				long steps = strtol(arg.c_str() + 9, &end, 10); // the budget the user asked for
+				if(end == arg.c_str() + 9 || *end != '\0' || errno == ERANGE || steps <= 0 || steps > INT_MAX) // not a whole positive number
+				{
+					cout << endl << "[ERROR]The budget in \"" << arg << "\" must be a positive whole number of steps." << endl;
+					return 1; // exit with error
+				}
+				evaluate = true;
+				budget = (int)steps;
+			}
 		}
 	}
 	else // if s/he didn't...
@@ -60,6 +90,43 @@ int main(int argc, char *argv[])
 	// read source file into a string
 	string source((istreambuf_iterator<char>(sourceFile)), (istreambuf_iterator<char>()));
 	
+	////////// INCREMENTAL MODE /////////////////////////////////////
+	if(incremental)
+	{
+		Incremental_Session session(source, verbose); // compile every program once
+		// read edits, one per line, as: <offset> <number of characters removed> <inserted text>
+		// where the inserted text may use \n, \t, \r and \\ escapes
+		cout << "Ready for edits. (Ctrl+C to stop.)" << endl;
+		string line;
+		while(getline(cin, line))
+		{
+			stringstream edit(line);
+			int offset, removed;
+			if(!(edit >> offset >> removed) || removed < 0) // an edit cannot remove a negative number of characters
+			{
+				cout << "[ERROR]: Edits must be entered as <offset> <number removed> <inserted text>." << endl;
+				continue;
+			}
+			string text = "";
+			if(edit.get() == ' ') getline(edit, text); // the rest of the line is the inserted text
+			string inserted = "";
+			for(string::size_type i = 0; i < text.length(); ++i)
+			{
+				if(text.at(i) == '\\' && i+1 < text.length())
+				{
+					char c = text.at(++i);
+					if(c == 'n') inserted += '\n';
+					else if(c == 't') inserted += '\t';
+					else if(c == 'r') inserted += '\r';
+					else inserted += c;
+				}
+				else inserted += text.at(i);
+			}
+			session.edit(offset, removed, inserted);
+		}
+		return 0; // exit successful
+	}
+	
 	// split the source into multiple programs (if necessary)
 	regex eof("([$]|[^$]+)"); // match anything and EOF and anything after
 	regex_iterator<string::iterator> regIt(source.begin(), source.end(), eof);
@@ -173,9 +240,54 @@ int main(int argc, char *argv[])
 		// indicate completion of semantic analysis
 		cout << "Semantic Analysis complete!" << endl;
 		
+		////////// CONSTANT FOLDING ////////////////////////////////////
+		cout << "Performing Constant Folding..." << endl;
+		Constant_Folder folder(semantics.AST, semantics.strings, semantics.stringsMap, verbose);
+		
+		// report constant folding warnings here
+		cout << "[" << folder.numWarn << " constant folding warning(s) found.]" << endl;
+		
+		// indicate completion of constant folding
+		cout << "Constant Folding complete!" << endl;
+		
+		////////// COMPILE-TIME EVALUATION /////////////////////////////
+		// the program is always run, to find loops that never exit, but only replaced by its output if evaluation is on
+		cout << "Performing Compile-Time Evaluation..." << endl;
+		Evaluator evaluator(folder.AST, semantics.strings, semantics.stringsMap, budget, evaluate, verbose);
+		
+		// report compile-time evaluation warnings here
+		cout << "[" << evaluator.numWarn << " compile-time evaluation warning(s) found.]" << endl;
+		
+		// generate code for printing the output alone if the program finished
+		vector<AST_Node> program = folder.AST; // the AST to generate code for
+		if(evaluate && evaluator.finished)
+		{
+			program = evaluator.AST;
+			cout << "Compile-Time Evaluation complete! Only the output of the program will be printed." << endl;
+		}
+		else if(evaluator.endless)
+			cout << "Compile-Time Evaluation found a loop that never exits. The whole program will be compiled." << endl;
+		else if(evaluator.stopped)
+			cout << "Compile-Time Evaluation stopped at the step budget. The whole program will be compiled." << endl;
+		else if(evaluate)
+			cout << "Compile-Time Evaluation finished, but its output is too long to print alone. The whole program will be compiled." << endl;
+		else
+			cout << "Compile-Time Evaluation complete!" << endl;
+		
+		////////// DEAD STORE ELIMINATION ///////////////////////////////
+		cout << "Performing Dead Store Elimination..." << endl;
+		Dead_Store_Eliminator eliminator(program, verbose);
+		
+		// report what dead store elimination saved here
+		cout << "[" << eliminator.numRemoved << " dead store(s) removed.]"
+		<< " [" << eliminator.numFreed << " variable byte(s) freed.]" << endl;
+		
+		// indicate completion of dead store elimination
+		cout << "Dead Store Elimination complete!" << endl;
+		
 		////////// CODE GENERATION /////////////////////////////////////
 		cout << "Performing Code Generation..." << endl;
-		Code_Generator codeGen(semantics.AST, semantics.stringsMap, verbose);
+		Code_Generator codeGen(eliminator.AST, semantics.stringsMap, verbose);
 		
 		// report code gen errors here
 		cout << "[" << codeGen.numErrors << " code generation error(s) found.]"
@@ -0,0 +1,491 @@
+using namespace std;
+using std::string;
+using std::vector;
+
+// the Constant Folder class object definition
+// rebuilds the AST between semantic analysis and code generation with every expression it can evaluate replaced by a literal,
+// dropping the if and while statements that can never run and inlining the blocks of the if statements that always do
+// the values of variables are propagated from their assignments to their uses, only along the paths that can run
+// then each run of prints of literals becomes one print of a string literal holding all they print
+class Constant_Folder
+{
+	// public class access
+	public:
+		Constant_Folder(vector<AST_Node>&, vector<string>&, unordered_map<string, int>&, bool); // constructor
+		vector<AST_Node> AST; // the folded abstract syntax tree, in pre-order with the root at index 0
+		int numWarn; // number of warnings found
+	// private class access
+	private:
+		bool verbose;
+		vector<AST_Node> tree; // the abstract syntax tree being folded
+		vector<string> strings; // the string literals, indexed by the value of their AST nodes
+		vector<int> uses; // the number of nodes using each string literal
+		vector<string> folds; // what was folded, for verbose mode
+		vector<AST_Node> values; // the literal each variable slot is known to hold, or an id if it varies
+		bool emitting; // false while a loop is only looked through to find the variables it changes
+		AST_Node evaluate(int); // evaluates an expression to a literal if it can
+		bool literal(AST_Node&); // true if a node is a literal
+		bool same(AST_Node&, AST_Node&); // true if two literals are equal, or neither is a literal
+		void meet(vector<AST_Node>&); // keeps only the values known on another path too
+		void refine(int, bool); // learns a variable's value from a condition
+		void fold(int, int, bool); // lays out a node with its expressions folded
+		int emit(AST_Node, int); // lays out a single node
+		void copy(int, int); // lays out a subtree as it is
+		void finish(int); // ends the subtree of a node laid out
+		void note(int, string); // records a fold for verbose mode
+		void merge(int, int); // lays out a subtree with its runs of prints of literals merged
+		void statements(int, vector<int>&); // lists the statements of a block and the blocks inside it
+		bool constant(int); // true if a statement prints a literal
+		int line(int); // the line a node is on
+};
+
+// constructor
+Constant_Folder::Constant_Folder(vector<AST_Node>& semanticsAST, vector<string>& stringList, unordered_map<string, int>& stringsMap, bool v)
+{
+	verbose = v;
+	numWarn = 0; // start with no warnings
+	tree = semanticsAST;
+	strings = stringList;
+	emitting = true;
+
+	// nothing is known about any variable until it is declared
+	int numSlots = 0;
+	for(vector<AST_Node>::iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		if(it->kind == N_ID && it->slot >= numSlots)
+			numSlots = it->slot + 1;
+	}
+	AST_Node varies = tree[0];
+	varies.kind = N_ID;
+	values.assign(numSlots, varies);
+
+	// lay out the folded AST, starting at the root
+	fold(0, -1, false);
+
+	// merge the prints of literals in the folded AST
+	int folded = AST.size();
+	tree = AST;
+	AST.clear();
+	uses.assign(strings.size(), 0);
+	for(vector<AST_Node>::iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		if(it->kind == N_CHARS)
+			++uses[it->value];
+	}
+	merge(0, -1);
+	// the string literals the merged prints made are added for the passes after this one
+	for(int i = stringList.size(); i < (int)strings.size(); ++i)
+	{
+		stringsMap.emplace(strings[i], i);
+		stringList.push_back(strings[i]);
+	}
+
+	if(verbose) // if verbose mode is on
+	{
+		// print the folds
+		cout <<
+			"______________________________________________________________________" << endl <<
+			setw(27) << left << "" << "CONSTANT FOLDING" << setw(27) << right << "" << endl <<
+			"______________________________________________________________________" << endl;
+		for(vector<string>::iterator it = folds.begin(); it != folds.end(); ++it)
+			cout << "- " << *it << endl;
+		cout << "- Total: " << folds.size() << " fold(s), " << semanticsAST.size() << " node(s) -> " << folded << " node(s) -> " <<
+			AST.size() << " node(s) after merging prints" << endl;
+		cout << "______________________________________________________________________" << endl;
+	}
+}
+
+// function to check if a node is a literal
+// node	: the node
+bool Constant_Folder::literal(AST_Node& node)
+{
+	return node.kind == N_DIGIT || node.kind == N_TRUE || node.kind == N_FALSE || node.kind == N_CHARS;
+}
+
+// function to check if two values are the same
+// strings are compared by index, like the addresses the code compares
+// a	: the first value
+// b	: the second value
+bool Constant_Folder::same(AST_Node& a, AST_Node& b)
+{
+	if(!literal(a) || !literal(b)) return !literal(a) && !literal(b); // neither is known
+	return a.kind == b.kind && (a.value == b.value || a.kind == N_TRUE || a.kind == N_FALSE);
+}
+
+// function to keep only the variable values that are also known, and the same, on another path
+// other	: the values on the other path
+void Constant_Folder::meet(vector<AST_Node>& other)
+{
+	for(int s = 0; s < (int)values.size(); ++s)
+	{
+		if(!same(values[s], other[s]))
+			values[s].kind = N_ID; // the paths disagree, so it varies
+	}
+}
+
+// function to learn the value of a variable from a condition
+// only an <==> that holds (or an <!=> that doesn't) between a variable and a literal says what the variable is
+// cond		: index of the condition
+// holds	: whether the condition is true
+void Constant_Folder::refine(int cond, bool holds)
+{
+	AST_Node& node = tree[cond];
+	if((node.kind != N_EQUAL && node.kind != N_NOT_EQUAL) || holds != (node.kind == N_EQUAL)) return;
+	int left = cond+1; // the left side
+	int right = tree[left].end; // the right side
+	AST_Node value;
+	if(tree[left].kind == N_ID && literal(value = evaluate(right)))
+		values[tree[left].slot] = value;
+	else if(tree[right].kind == N_ID && literal(value = evaluate(left)))
+		values[tree[right].slot] = value;
+}
+
+// function to evaluate an expression to a literal
+// variables with known values become those values, <+>s of digits add up to a digit as long as they stay within
+// the maximum value of an integer (the code generator warns otherwise) and comparisons of literals, or of a variable
+// with itself, become true or false
+// n	: index of the expression in the tree being folded
+// returns the literal, or the node itself if it can't be evaluated
+AST_Node Constant_Folder::evaluate(int n)
+{
+	AST_Node node = tree[n];
+	int first = n+1; // index of the first child
+	switch(node.kind)
+	{
+		case N_ID:
+		{
+			AST_Node& value = values[node.slot];
+			if(literal(value))
+			{
+				node.kind = value.kind;
+				node.value = value.value;
+			}
+			break;
+		}
+		case N_ADD:
+		{
+			AST_Node rest = evaluate(tree[first].end); // the right side
+			int sum = tree[first].value + rest.value; // the left side is always a digit
+			if(rest.kind == N_DIGIT && sum <= 255)
+			{
+				node.kind = N_DIGIT;
+				node.value = sum;
+				node.numChildren = 0;
+			}
+			break;
+		}
+		case N_EQUAL:
+		case N_NOT_EQUAL:
+		{
+			AST_Node left = evaluate(first);
+			AST_Node right = evaluate(tree[first].end);
+			bool equal = false; // whether the sides are equal
+			if(literal(left) && literal(right))
+				equal = same(left, right);
+			else if(left.kind == N_ID && right.kind == N_ID && left.slot == right.slot)
+				equal = true; // a variable always equals itself
+			else
+				break;
+			node.kind = (equal == (node.kind == N_EQUAL)) ? N_TRUE : N_FALSE;
+			node.value = 0;
+			node.numChildren = 0;
+			break;
+		}
+		default: // literals are already as simple as they get
+			break;
+	}
+	return node;
+}
+
+// function to lay out a node in the folded AST, folding its subtree on the way
+// statements update the values known for the variables they assign
+// n		: index of the node in the tree being folded
+// parent	: index of the parent in the folded AST (-1 for the root)
+// printed	: true if the node is what a print statement prints
+void Constant_Folder::fold(int n, int parent, bool printed)
+{
+	AST_Node& node = tree[n];
+	int first = n+1; // index of the first child
+	int second = (node.numChildren > 1) ? tree[first].end : first; // index of the second child
+	switch(node.kind)
+	{
+		case N_ID:
+		case N_ADD:
+		case N_EQUAL:
+		case N_NOT_EQUAL:
+		{
+			AST_Node value = evaluate(n);
+			if(literal(value))
+			{
+				if(printed && (value.kind == N_TRUE || value.kind == N_FALSE)) // a printed boolean prints as a number
+				{
+					value.value = (value.kind == N_TRUE) ? 1 : 0;
+					value.kind = N_DIGIT;
+				}
+				note(n, (value.kind == N_DIGIT) ? to_string(value.value) : (value.kind == N_TRUE) ? "true" :
+					(value.kind == N_FALSE) ? "false" : "a string literal");
+				value.lineNum = line(n); // an operator has no line of its own, but the literal needs one for warnings
+				emit(value, parent);
+				return;
+			}
+			if(node.kind == N_ADD)
+			{
+				// add up the digits in front of the variable the <+> ends in
+				int sum = 0;
+				int rest = n; // the rest of the <+>
+				for(; tree[rest].kind == N_ADD; rest = tree[rest+1].end)
+					sum += tree[rest+1].value;
+				if(sum == 0 && tree[rest].kind == N_ID) // 0 + x is x
+				{
+					note(n, "the variable alone");
+					fold(rest, parent, printed);
+					return;
+				}
+				if(sum <= 255 && rest != second) // more than one digit to add up
+				{
+					note(n, "one <+> of " + to_string(sum));
+					AST_Node digit = tree[first];
+					digit.value = sum;
+					int add = emit(node, parent);
+					emit(digit, add);
+					fold(rest, add, false);
+					finish(add);
+					return;
+				}
+			}
+			break;
+		}
+		case N_VAR_DECL:
+		{
+			AST_Node& var = tree[second];
+			// ints start at 0 and booleans at false, while strings start at an empty string no literal shares
+			AST_Node& value = values[var.slot];
+			value = var;
+			value.kind = (var.type == TYPE_INT) ? N_DIGIT : (var.type == TYPE_BOOLEAN) ? N_FALSE : N_ID;
+			value.value = 0;
+			copy(n, parent);
+			return;
+		}
+		case N_ASSIGNMENT_STATEMENT:
+		{
+			AST_Node value = evaluate(second); // from the values before the assignment
+			int index = emit(node, parent);
+			// the semantic analyzer leaves a copy of one variable to another without a type, but the code generator
+			// lowers the right hand side by it, so a copy folded to a literal needs the type of the variable assigned
+			if(index >= 0) AST[index].type = tree[first].type;
+			copy(first, index); // the variable assigned
+			fold(second, index, false);
+			finish(index);
+			values[tree[first].slot] = literal(value) ? value : tree[first];
+			return;
+		}
+		case N_IF_STATEMENT:
+		{
+			AST_Node condition = evaluate(first);
+			if(condition.kind == N_FALSE) // the block never runs
+			{
+				if(emitting)
+				{
+					cout << "[WARN]Line " << line(first) << ": " << "This if statement will never be executed." << endl;
+					++numWarn;
+				}
+				note(n, "nothing");
+				return;
+			}
+			if(condition.kind == N_TRUE) // the block always runs
+			{
+				note(n, "its block");
+				fold(second, parent, false);
+				return;
+			}
+			int index = emit(node, parent);
+			fold(first, index, false);
+			vector<AST_Node> skipped = values; // the values if the block is skipped
+			refine(first, true);
+			fold(second, index, false);
+			finish(index);
+			meet(skipped);
+			return;
+		}
+		case N_WHILE_STATEMENT:
+		{
+			// find the values at the top of the loop by going around it until they settle
+			// they only settle by varying, so it goes around at most once more than there are variables
+			bool was = emitting;
+			emitting = false;
+			while(evaluate(first).kind != N_FALSE)
+			{
+				vector<AST_Node> top = values; // the values at the top of the loop
+				refine(first, true);
+				fold(second, -1, false); // around the loop once
+				meet(top);
+				bool settled = true;
+				for(int s = 0; s < (int)values.size(); ++s)
+					settled = settled && same(values[s], top[s]);
+				if(settled) break;
+			}
+			emitting = was;
+			if(evaluate(first).kind == N_FALSE) // the block never runs
+			{
+				if(emitting)
+				{
+					cout << "[WARN]Line " << line(first) << ": " << "This loop will never be executed." << endl;
+					++numWarn;
+				}
+				note(n, "nothing");
+				return;
+			}
+			int index = emit(node, parent);
+			fold(first, index, false);
+			vector<AST_Node> top = values;
+			refine(first, true);
+			fold(second, index, false);
+			finish(index);
+			values = top;
+			refine(first, false); // the loop only ends once the condition is false
+			return;
+		}
+		default:
+			break;
+	}
+	// lay out the node and fold its children
+	int index = emit(node, parent);
+	for(int c = first; c < node.end; c = tree[c].end) // for each child node
+		fold(c, index, node.kind == N_PRINT_STATEMENT);
+	finish(index);
+}
+
+// function to lay out a single node in the folded AST
+// nothing is laid out while a loop is only looked through
+// node		: the node
+// parent	: index of its parent in the folded AST (-1 for the root)
+// returns the index of the node (-1 if it wasn't laid out)
+int Constant_Folder::emit(AST_Node node, int parent)
+{
+	if(!emitting) return -1;
+	node.numChildren = 0; // children are counted as they are laid out
+	node.end = AST.size()+1; // a leaf until its children are laid out
+	if(parent >= 0) ++AST[parent].numChildren; // one more child for the parent
+	AST.push_back(node);
+	return AST.size()-1;
+}
+
+// function to lay out a subtree in the folded AST as it is
+// n		: index of the subtree in the tree being folded
+// parent	: index of its parent in the folded AST
+void Constant_Folder::copy(int n, int parent)
+{
+	int index = emit(tree[n], parent);
+	for(int c = n+1; c < tree[n].end; c = tree[c].end) // for each child node
+		copy(c, index);
+	finish(index);
+}
+
+// function to end the subtree of a node laid out in the folded AST after its last descendant
+// index	: index of the node in the folded AST (-1 if it wasn't laid out)
+void Constant_Folder::finish(int index)
+{
+	if(index >= 0)
+		AST[index].end = AST.size();
+}
+
+// function to record a fold for verbose mode
+// n	: index of the node folded
+// to	: what it was folded to
+void Constant_Folder::note(int n, string to)
+{
+	if(!emitting) return;
+	AST_Node& node = tree[n];
+	string from = (node.kind == N_ID) ? kindName(N_ID, node.value, "") : (node.kind == N_ADD) ? "<+>" :
+		(node.kind == N_EQUAL) ? "<==>" : (node.kind == N_NOT_EQUAL) ? "<!=>" :
+		(node.kind == N_IF_STATEMENT) ? "if statement" : "while statement";
+	folds.push_back("Line " + to_string(line(n)) + ": " + from + " folded to " + to);
+}
+
+// function to find the line a node is on
+// n	: index of the node
+// returns the line of the node, or of its first token if it has no line of its own
+int Constant_Folder::line(int n)
+{
+	int i = n;
+	while(tree[i].lineNum == 0 && i+1 < tree[n].end) ++i; // operators take their line from their first token
+	return tree[i].lineNum;
+}
+
+// function to lay out a subtree of the folded AST with each run of prints of literals in a block merged into one print
+// printing a digit gives its number, printing true or false gives the word and printing a string literal gives its characters,
+// all with nothing in between, so a run prints exactly what one string literal of them all together does
+// a block directly inside another is only its statements, so the prints in it can merge with the ones around it
+// n		: index of the node in the folded AST
+// parent	: index of its parent in the merged AST (-1 for the root)
+void Constant_Folder::merge(int n, int parent)
+{
+	int index = emit(tree[n], parent);
+	if(tree[n].kind != N_BLOCK)
+	{
+		for(int c = n+1; c < tree[n].end; c = tree[c].end) // for each child node
+			merge(c, index);
+		finish(index);
+		return;
+	}
+	vector<int> list; // the statements of the block
+	statements(n, list);
+	for(int i = 0; i < (int)list.size(); ++i)
+	{
+		if(!constant(list[i])) // nothing to merge
+		{
+			merge(list[i], index);
+			continue;
+		}
+		// a string literal used anywhere else has to stay in memory, so it ends the run where the merged literal can share it
+		int last = i;
+		while(last+1 < (int)list.size() && constant(list[last+1]) &&
+			!(tree[list[last]+1].kind == N_CHARS && uses[tree[list[last]+1].value] > 1))
+			++last;
+		if(last == i) // only one print
+		{
+			merge(list[i], index);
+			continue;
+		}
+		string text; // what the run prints
+		for(int p = i; p <= last; ++p)
+		{
+			AST_Node& value = tree[list[p]+1];
+			text += (value.kind == N_DIGIT) ? to_string(value.value) : (value.kind == N_TRUE) ? "true" :
+				(value.kind == N_FALSE) ? "false" : strings.at(value.value);
+		}
+		AST_Node literal = tree[list[i]+1];
+		literal.kind = N_CHARS;
+		literal.type = TYPE_STRING;
+		literal.value = find(strings.begin(), strings.end(), text) - strings.begin(); // the literal, if the program has it already
+		if(literal.value == (int)strings.size())
+			strings.push_back(text);
+		int print = emit(tree[list[i]], index);
+		emit(literal, print);
+		finish(print);
+		folds.push_back("Line " + to_string(line(list[i])) + ": " + to_string(last-i+1) + " prints merged into one print of \"" + text + "\"");
+		i = last;
+	}
+	finish(index);
+}
+
+// function to list the statements of a block, along with the statements of the blocks directly inside it
+// n	: index of the block in the folded AST
+// list	: the list to add to
+void Constant_Folder::statements(int n, vector<int>& list)
+{
+	for(int c = n+1; c < tree[n].end; c = tree[c].end) // for each child node
+	{
+		if(tree[c].kind == N_BLOCK)
+			statements(c, list);
+		else
+			list.push_back(c);
+	}
+}
+
+// function to check if a statement prints a literal
+// n	: index of the statement in the folded AST
+bool Constant_Folder::constant(int n)
+{
+	return tree[n].kind == N_PRINT_STATEMENT && literal(tree[n+1]);
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+using namespace std;
+using std::string;
+using std::vector;
+
+// the Dead Store Eliminator class object definition
+// rebuilds the AST without the assignments and declarations whose values are never read,
+// then gives the variables still left the lowest slots so the ones removed take no memory,
+// and variables that are never live at the same time, like ones declared in sibling blocks, share a slot
+class Dead_Store_Eliminator
+{
+	// public class access
+	public:
+		Dead_Store_Eliminator(vector<AST_Node>&, bool); // constructor
+		vector<AST_Node> AST; // the abstract syntax tree without dead stores, in pre-order with the root at index 0
+		int numRemoved; // number of statements removed
+		int numFreed; // number of variable bytes freed
+	// private class access
+	private:
+		bool verbose;
+		vector<AST_Node> tree; // the abstract syntax tree being looked through
+		vector<bool> dead; // the statements whose stores are never read, by index
+		vector<string> removals; // what was removed, for verbose mode
+		bool marking; // false while a loop is only looked through to find what is live at its test
+		bool linking; // true while finding which variables are live at the same time
+		vector<vector<bool>> interferes; // true for each pair of slots live at the same time, which can't share a byte
+		vector<string> overlays; // the variables sharing a byte, for verbose mode
+		vector<bool> liveIn(int, vector<bool>); // the variables live before a statement
+		void uses(int, vector<bool>&); // adds the variables an expression reads
+		bool empty(int); // true if nothing in a block is left
+		void copy(int, int); // lays out a subtree without its dead statements
+		void note(int, string); // records a removal for verbose mode
+};
+
+// constructor
+Dead_Store_Eliminator::Dead_Store_Eliminator(vector<AST_Node>& programAST, bool v)
+{
+	verbose = v;
+	AST = programAST;
+	numRemoved = 0; // nothing removed yet
+	linking = false;
+	int numSlots = 0;
+	for(vector<AST_Node>::iterator it = AST.begin(); it != AST.end(); ++it)
+	{
+		if(it->kind == N_ID && it->slot >= numSlots)
+			numSlots = it->slot + 1;
+	}
+
+	// removing a store can leave an if statement with nothing to do, whose condition then reads nothing, so go until nothing changes
+	do
+	{
+		tree = AST;
+		AST.clear();
+		dead.assign(tree.size(), false);
+		marking = true;
+		liveIn(0, vector<bool>(numSlots, false)); // nothing is live once the program ends
+		copy(0, -1);
+	} while(AST.size() < tree.size());
+
+	// once nothing more can be removed, go through once more to find which variables are live at the same time
+	tree = AST;
+	dead.assign(tree.size(), false);
+	marking = true;
+	linking = true;
+	interferes.assign(numSlots, vector<bool>(numSlots, false));
+	liveIn(0, vector<bool>(numSlots, false));
+	linking = false;
+
+	// the name and line of each variable left, for verbose mode
+	vector<string> names(numSlots, "");
+	for(vector<AST_Node>::iterator it = AST.begin(); it != AST.end(); ++it)
+	{
+		if(it->kind == N_ID && names[it->slot].empty())
+			names[it->slot] = kindName(N_ID, it->value, "") + " (line " + to_string(it->lineNum) + ")";
+	}
+
+	// in the order they were declared, each variable left takes the lowest slot no variable live at the same time has
+	vector<int> slots(numSlots, -1); // the new slot of each slot
+	int numLeft = 0; // the number of slots left
+	for(int s = 0; s < numSlots; ++s)
+	{
+		if(names[s].empty()) continue; // removed
+		vector<int> sharing(numLeft, -1); // a slot already given each new slot, or -2 if one live at the same time has it
+		for(int t = 0; t < s; ++t)
+		{
+			if(slots[t] < 0) continue;
+			if(interferes[s][t])
+				sharing[slots[t]] = -2;
+			else if(sharing[slots[t]] == -1)
+				sharing[slots[t]] = t;
+		}
+		int slot = 0;
+		while(slot < numLeft && sharing[slot] == -2) ++slot;
+		if(slot == numLeft)
+			++numLeft; // a new byte
+		else
+			overlays.push_back(names[s] + " shares a byte with " + names[sharing[slot]]);
+		slots[s] = slot;
+	}
+	for(vector<AST_Node>::iterator it = AST.begin(); it != AST.end(); ++it)
+	{
+		if(it->kind == N_ID)
+			it->slot = slots[it->slot];
+	}
+	numFreed = numSlots - numLeft;
+
+	if(verbose) // if verbose mode is on
+	{
+		// print the removals
+		cout <<
+			"______________________________________________________________________" << endl <<
+			setw(23) << left << "" << "DEAD STORE ELIMINATION" << setw(25) << right << "" << endl <<
+			"______________________________________________________________________" << endl;
+		for(vector<string>::iterator it = removals.begin(); it != removals.end(); ++it)
+			cout << "- " << *it << endl;
+		for(vector<string>::iterator it = overlays.begin(); it != overlays.end(); ++it)
+			cout << "- " << *it << endl;
+		cout << "- Total: " << numRemoved << " removal(s), " << numFreed << " variable byte(s) freed" << endl;
+		cout << "______________________________________________________________________" << endl;
+	}
+}
+
+// function to find the variables that may be read after a statement runs before they are assigned again
+// statements whose stores are not live after them are marked dead on the way
+// n	: index of the statement
+// out	: the variables live after the statement
+// returns the variables live before the statement
+vector<bool> Dead_Store_Eliminator::liveIn(int n, vector<bool> out)
+{
+	AST_Node& node = tree[n];
+	int first = n+1; // index of the first child
+	int second = (node.numChildren > 1) ? tree[first].end : first; // index of the second child
+	switch(node.kind)
+	{
+		case N_BLOCK:
+		{
+			vector<int> statements; // the statements, to go through backwards
+			for(int c = first; c < node.end; c = tree[c].end) // for each child node
+				statements.push_back(c);
+			for(int i = statements.size()-1; i >= 0; --i)
+				out = liveIn(statements[i], out);
+			break;
+		}
+		case N_VAR_DECL:
+		case N_ASSIGNMENT_STATEMENT:
+		{
+			int slot = tree[(node.kind == N_VAR_DECL) ? second : first].slot; // the variable stored
+			bool same = node.kind == N_ASSIGNMENT_STATEMENT && tree[second].kind == N_ID && tree[second].slot == slot; // x = x
+			if(!out[slot] || same) // never read before it is assigned again, or stored with what it already holds
+			{
+				if(marking) dead[n] = true;
+				break;
+			}
+			if(linking) // the variable stored can't share a byte with any other variable live after the store
+			{
+				for(int s = 0; s < (int)out.size(); ++s)
+				{
+					if(out[s] && s != slot)
+						interferes[slot][s] = interferes[s][slot] = true;
+				}
+			}
+			out[slot] = false; // assigned here
+			if(node.kind == N_ASSIGNMENT_STATEMENT)
+				uses(second, out);
+			break;
+		}
+		case N_PRINT_STATEMENT:
+		{
+			uses(first, out);
+			break;
+		}
+		case N_IF_STATEMENT:
+		{
+			vector<bool> in = liveIn(second, out);
+			for(int s = 0; s < (int)out.size(); ++s)
+				out[s] = out[s] || in[s]; // the block may be skipped
+			uses(first, out);
+			break;
+		}
+		case N_WHILE_STATEMENT:
+		{
+			// what is live at the test grows each time around the loop until it settles
+			vector<bool> test = out; // the variables live at the test
+			uses(first, test);
+			bool was = marking;
+			marking = false;
+			while(true)
+			{
+				vector<bool> in = liveIn(second, test); // around the loop once
+				for(int s = 0; s < (int)out.size(); ++s)
+					in[s] = in[s] || out[s]; // the loop may end
+				uses(first, in);
+				if(in == test) break;
+				test = in;
+			}
+			marking = was;
+			liveIn(second, test); // once more to mark the block
+			out = test;
+			break;
+		}
+		default:
+			break;
+	}
+	return out;
+}
+
+// function to add the variables an expression reads
+// n	: index of the expression
+// live	: the variables to add to
+void Dead_Store_Eliminator::uses(int n, vector<bool>& live)
+{
+	for(int i = n; i < tree[n].end; ++i)
+	{
+		if(tree[i].kind == N_ID)
+			live[tree[i].slot] = true;
+	}
+}
+
+// function to check if nothing is left in a block once its dead statements are removed
+// n	: index of the block
+bool Dead_Store_Eliminator::empty(int n)
+{
+	for(int c = n+1; c < tree[n].end; c = tree[c].end) // for each statement
+	{
+		if(!dead[c] && !(tree[c].kind == N_IF_STATEMENT && empty(tree[c+1].end)))
+			return false;
+	}
+	return true;
+}
+
+// function to lay out a subtree without its dead statements
+// n		: index of the subtree
+// parent	: index of its parent in the new AST (-1 for the root)
+void Dead_Store_Eliminator::copy(int n, int parent)
+{
+	AST_Node node = tree[n];
+	if(dead[n]) // never read
+	{
+		note(n, (node.kind == N_VAR_DECL) ? "declaration of " + kindName(N_ID, tree[tree[n+1].end].value, "") :
+			"store to " + kindName(N_ID, tree[n+1].value, ""));
+		return;
+	}
+	if(node.kind == N_IF_STATEMENT && empty(tree[n+1].end)) // nothing left to do
+	{
+		note(n, "if statement left with nothing to do");
+		return;
+	}
+	node.numChildren = 0; // children are counted as they are laid out
+	if(parent >= 0) ++AST[parent].numChildren; // one more child for the parent
+	AST.push_back(node);
+	int index = AST.size()-1;
+	for(int c = n+1; c < tree[n].end; c = tree[c].end) // for each child node
+		copy(c, index);
+	AST[index].end = AST.size(); // the subtree ends after its last descendant
+}
+
+// function to record a removal for verbose mode
+// n	: index of the statement removed
+// what	: what was removed
+void Dead_Store_Eliminator::note(int n, string what)
+{
+	int line = n;
+	while(tree[line].lineNum == 0 && line+1 < tree[n].end) ++line; // the first line the statement has
+	removals.push_back("Line " + to_string(tree[line].lineNum) + ": " + what + " removed");
+	++numRemoved;
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+using namespace std;
+using std::string;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+
+// the Evaluator class object definition
+// programs take no input, so running the checked AST at compile time gives exactly what the program prints;
+// if it finishes within a budget of steps, the AST is replaced with one that only prints that output
+// the state of a program is only its variables, so a loop that comes back around to a state it was in never exits
+class Evaluator
+{
+	// public class access
+	public:
+		Evaluator(vector<AST_Node>&, vector<string>&, unordered_map<string, int>&, int, bool, bool); // constructor
+		vector<AST_Node> AST; // an AST printing the output, if the program finished and its output replaces it
+		bool finished; // true if the program finished within the budget and its output fits in memory
+		bool stopped; // true once the budget runs out or a loop is found to never exit
+		bool endless; // true if a loop was found to never exit
+		int numWarn; // number of warnings found
+	// private class access
+	private:
+		bool verbose;
+		bool replace; // true if the output replaces the program when it finishes
+		vector<AST_Node> tree; // the abstract syntax tree being run
+		vector<string> strings; // the string literals, indexed by the value of their AST nodes
+		vector<int> memory; // the byte each variable slot holds - an int, 1 or 0 for booleans, or a string's index (-1 if empty)
+		vector<bool> warned; // the <+>s already warned about, by index
+		vector<string> warnings; // the warnings, given only if the program finishes (the code generator gives them otherwise)
+		string output; // everything printed so far
+		int steps; // the statements run so far
+		int budget; // the most statements to run before giving up
+		unordered_set<string> states; // the loop each test of a condition was at, along with the values of the variables
+		void run(int); // runs a statement
+		bool repeats(int); // true if a loop is back in a state it was in
+		string show(int); // the value of a variable as it reads in the source
+		int value(int); // evaluates an expression
+		string text(int); // the text printing an expression gives
+};
+
+// constructor
+Evaluator::Evaluator(vector<AST_Node>& foldedAST, vector<string>& stringList, unordered_map<string, int>& stringsMap, int b, bool e, bool v)
+{
+	verbose = v;
+	replace = e;
+	numWarn = 0; // start with no warnings
+	tree = foldedAST;
+	strings = stringList;
+	budget = b;
+	steps = 0;
+	stopped = false;
+	endless = false;
+	warned.assign(tree.size(), false);
+	int numSlots = 0;
+	for(vector<AST_Node>::iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		if(it->kind == N_ID && it->slot >= numSlots)
+			numSlots = it->slot + 1;
+	}
+	memory.assign(numSlots, 0);
+
+	// run the program from the root
+	run(0);
+
+	// the output is printed as one string literal: 6 bytes of code, the literal and its end-of-string character,
+	// and byte 255 for the empty string
+	finished = !stopped && output.length() + 9 <= 256;
+	if(finished && replace) // otherwise the code generator gives the warnings for the program it compiles
+	{
+		for(vector<string>::iterator it = warnings.begin(); it != warnings.end(); ++it)
+		{
+			cout << *it << endl;
+			++numWarn;
+		}
+		// { print("<output>") }, or just { } if nothing is printed
+		AST.push_back(tree[0]);
+		AST[0].numChildren = 0;
+		if(!output.empty())
+		{
+			AST[0].numChildren = 1;
+			AST_Node print = tree[0];
+			print.kind = N_PRINT_STATEMENT;
+			print.type = TYPE_VOID;
+			print.numChildren = 1;
+			print.end = 3;
+			AST.push_back(print);
+			AST_Node literal = print;
+			literal.kind = N_CHARS;
+			literal.type = TYPE_STRING;
+			literal.value = stringsMap.emplace(output, stringsMap.size()).first->second; // the output is a new string literal
+			literal.numChildren = 0;
+			AST.push_back(literal);
+		}
+		AST[0].end = AST.size();
+	}
+
+	if(verbose) // if verbose mode is on
+	{
+		cout <<
+			"______________________________________________________________________" << endl <<
+			setw(23) << left << "" << "COMPILE-TIME EVALUATION" << setw(24) << right << "" << endl <<
+			"______________________________________________________________________" << endl;
+		if(endless)
+			cout << "- Stopped after " << steps << " step(s) at a loop that never exits, having seen " << states.size() << " state(s)" << endl;
+		else if(stopped)
+			cout << "- Stopped after " << budget << " step(s) without finishing" << endl;
+		else
+			cout << "- Finished in " << steps << " step(s), printing \"" << output << "\"" << endl;
+		cout << "______________________________________________________________________" << endl;
+	}
+}
+
+// function to run a statement
+// n	: index of the statement
+void Evaluator::run(int n)
+{
+	if(++steps > budget) stopped = true; // out of steps, so stop running anything
+	if(stopped) return;
+	AST_Node& node = tree[n];
+	int first = n+1; // index of the first child
+	int second = (node.numChildren > 1) ? tree[first].end : first; // index of the second child
+	switch(node.kind)
+	{
+		case N_BLOCK:
+		{
+			for(int c = first; c < node.end && !stopped; c = tree[c].end) // for each child node
+				run(c);
+			break;
+		}
+		case N_VAR_DECL:
+		{
+			AST_Node& var = tree[second];
+			memory[var.slot] = (var.type == TYPE_STRING) ? -1 : 0; // strings start empty, everything else at 0
+			break;
+		}
+		case N_ASSIGNMENT_STATEMENT:
+		{
+			memory[tree[first].slot] = value(second);
+			break;
+		}
+		case N_PRINT_STATEMENT:
+		{
+			output += text(first);
+			break;
+		}
+		case N_IF_STATEMENT:
+		{
+			if(value(first))
+				run(second);
+			break;
+		}
+		case N_WHILE_STATEMENT:
+		{
+			while(!stopped && !repeats(n) && value(first))
+			{
+				run(second);
+				if(++steps > budget) stopped = true; // each test of the condition is a step too, so an empty loop still runs out
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+// function to check if a loop is back in a state it was in before testing its condition
+// nothing but the variables changes as a program runs, so from the same loop with the same values it goes around forever
+// n	: index of the while statement
+bool Evaluator::repeats(int n)
+{
+	string state = to_string(n) + ":"; // the loop and the values of the variables
+	for(vector<int>::iterator it = memory.begin(); it != memory.end(); ++it)
+		state += (char)(*it + 1); // a string's index is -1 if empty
+	if(states.count(state) == 0)
+	{
+		if(states.size() < 65536) // keep to a budget of states, after which only the step budget stops the program
+			states.insert(state);
+		return false;
+	}
+	stopped = true;
+	endless = true;
+	if(tree[n+1].kind != N_TRUE) // the code generator already warns about loops on [true]
+	{
+		// the variables the loop uses, in the order they first appear
+		string values;
+		vector<bool> listed(memory.size(), false);
+		for(int i = n; i < tree[n].end; ++i)
+		{
+			if(tree[i].kind != N_ID || listed[tree[i].slot]) continue;
+			listed[tree[i].slot] = true;
+			values += (values.empty() ? "" : ", ") + kindName(N_ID, tree[i].value, "") + " = " + show(i);
+		}
+		int line = n;
+		while(tree[line].lineNum == 0 && line+1 < tree[n].end) ++line; // the first line the loop has
+		cout << "[WARN]Line " << tree[line].lineNum << ": " << "This loop never exits. It keeps coming back around with " <<
+			(values.empty() ? "nothing changed" : values) << "." << endl;
+		++numWarn;
+	}
+	return true;
+}
+
+// function to show the value of a variable as it reads in the source
+// n	: index of an id of the variable
+string Evaluator::show(int n)
+{
+	int value = memory[tree[n].slot];
+	if(tree[n].type == TYPE_BOOLEAN)
+		return value ? "true" : "false";
+	if(tree[n].type == TYPE_STRING)
+		return "\"" + ((value < 0) ? "" : strings.at(value)) + "\"";
+	return to_string(value);
+}
+
+// function to evaluate an expression the way the generated code does
+// n	: index of the expression
+// returns the byte the expression gives
+int Evaluator::value(int n)
+{
+	AST_Node& node = tree[n];
+	switch(node.kind)
+	{
+		case N_DIGIT:
+		case N_CHARS:
+			return node.value;
+		case N_TRUE:
+			return 1;
+		case N_FALSE:
+			return 0;
+		case N_ID:
+			return memory[node.slot];
+		case N_ADD:
+		{
+			// the digits add up at compile time, up to the maximum value, and a variable at the end is added at run time
+			int sum = 0;
+			int rest = n; // the rest of the <+>
+			for(; tree[rest].kind == N_ADD; rest = tree[rest+1].end)
+				sum += tree[rest+1].value;
+			if(tree[rest].kind == N_DIGIT) sum += tree[rest].value;
+			if(sum > 255) // passed max int value
+			{
+				if(!warned[n])
+				{
+					warnings.push_back("[WARN]Line " + to_string(node.lineNum) + ": " + "The maximum value of an integer is 255. Compilation will continue with the max.");
+					warned[n] = true;
+				}
+				sum = 255;
+			}
+			if(tree[rest].kind == N_ID)
+				sum = (sum + memory[tree[rest].slot]) % 256; // the byte wraps around
+			return sum;
+		}
+		case N_EQUAL:
+		case N_NOT_EQUAL:
+		{
+			bool equal = value(n+1) == value(tree[n+1].end);
+			return (equal == (node.kind == N_EQUAL)) ? 1 : 0;
+		}
+		default:
+			return 0;
+	}
+}
+
+// function to find the text printing an expression gives
+// n	: index of the expression
+string Evaluator::text(int n)
+{
+	AST_Node& node = tree[n];
+	if(node.kind == N_TRUE || node.kind == N_FALSE) // boolean literals print as words
+		return (node.kind == N_TRUE) ? "true" : "false";
+	if(node.type == TYPE_STRING || node.kind == N_CHARS) // strings print their characters
+	{
+		int index = value(n);
+		return (index < 0) ? "" : strings.at(index);
+	}
+	return to_string(value(n)); // everything else prints as a number
+}
\ No newline at end of file
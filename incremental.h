@@ -0,0 +1,173 @@
+using namespace std;
+using std::string;
+using std::queue;
+using std::vector;
+using std::unique_ptr;
+
+// the Incremental Session class object definition
+// keeps the tokens and concrete syntax tree of every program in a source file between edits,
+// so an edit only re-lexes and reparses the part of the one program it touches
+class Incremental_Session
+{
+	// public class access
+	public:
+		Incremental_Session(string, bool); // constructor
+		void edit(int, int, string); // applies a text edit and reports the edited program's diagnostics
+	// private class access
+	private:
+		bool verbose; // verbose output?
+		vector<string> programs; // the source text of each program
+		vector<int> starts; // offset of each program within the source file
+		vector<unique_ptr<Lexer> > lexers; // the lexer of each program, holding its tokens
+		vector<unique_ptr<Parser> > parsers; // the parser of each program, holding its CST (nullptr after lexical errors)
+		void split(string);
+		void compile(int);
+		void analyze(int);
+		void collect(Node&, vector<queue<Node>*>&);
+};
+
+// the Incremental Session constructor
+// source	: the text of the whole source file
+// v		: true if verbose output should happen
+Incremental_Session::Incremental_Session(string source, bool v)
+{
+	verbose = v;
+	split(source);
+	for(int p = 0; p < (int)programs.size(); ++p)
+	{
+		compile(p);
+		analyze(p);
+	}
+}
+
+// function to apply a text edit to the source file
+// offset	: where the edit starts in the source file
+// removed	: the number of characters the edit removes
+// inserted	: the text the edit inserts
+void Incremental_Session::edit(int offset, int removed, string inserted)
+{
+	// find the program the edit falls in; an insertion between two programs belongs to the later one
+	int p = programs.size()-1;
+	while(p > 0 && starts[p] > offset) --p;
+	int local = (p < 0) ? 0 : offset - starts[p]; // offset of the edit within the program
+
+	// edits that cross programs or add or remove a $ move program boundaries, so split the file again
+	if(p < 0 || local < 0 || local + removed > (int)programs[p].length() ||
+		(local == (int)programs[p].length() && programs[p].at(local-1) == '$') ||
+		programs[p].find('$', local) < (string::size_type)(local+removed) || inserted.find('$') != string::npos)
+	{
+		string source = "";
+		for(vector<string>::iterator it = programs.begin(); it != programs.end(); ++it)
+			source += *it;
+		if(offset < 0 || offset + removed > (int)source.length())
+		{
+			cout << "[ERROR]: The edit does not fall within the source file." << endl;
+			return;
+		}
+		source.replace(offset, removed, inserted);
+		cout << "Program boundaries changed. Recompiling every program..." << endl;
+		split(source);
+		for(int q = 0; q < (int)programs.size(); ++q)
+		{
+			compile(q);
+			analyze(q);
+		}
+		return;
+	}
+
+	cout << " _____________________________" << endl <<
+	"| RECOMPILING PROGRAM No." << right << setw(4) << p+1 << " |" << endl <<
+	"+_____________________________+_______________________________________"<< endl;
+	programs[p].replace(local, removed, inserted);
+	for(int q = p+1; q < (int)programs.size(); ++q)
+		starts[q] += inserted.length() - removed; // later programs only move
+
+	int first, oldEnd, newEnd, lineDelta; // the tokens the edit changed
+	if(!lexers[p]->relex(local, removed, inserted, first, oldEnd, newEnd, lineDelta))
+	{
+		compile(p); // the edit left or introduced lexical errors, so lex and parse from scratch
+	}
+	else if(parsers[p] == nullptr || !parsers[p]->reparse(lexers[p]->tokens, first, oldEnd, newEnd, lineDelta))
+	{
+		// the edit changed the program's structure or left it unparseable, so parse from scratch
+		queue<Token> que;
+		for(vector<Token>::iterator it = lexers[p]->tokens.begin(); it != lexers[p]->tokens.end(); ++it)
+			que.push(*it);
+		parsers[p].reset(new Parser(que, verbose)); // the old parser is freed
+	}
+	else if(verbose)
+	{
+		cout << "Re-lexed and reparsed " << newEnd - first << " token(s) in place." << endl;
+	}
+	analyze(p);
+}
+
+// function to split a source file into its programs, each ending with a $
+// source	: the text of the whole source file
+void Incremental_Session::split(string source)
+{
+	programs.clear();
+	starts.clear();
+	lexers.clear();
+	parsers.clear();
+	int start = 0; // where the current program starts
+	for(int i = 0; i < (int)source.length(); ++i)
+	{
+		if(source.at(i) == '$')
+		{
+			programs.push_back(source.substr(start, i+1-start));
+			starts.push_back(start);
+			start = i+1;
+		}
+	}
+	if(start < (int)source.length()) // add program with forgotten $
+	{
+		programs.push_back(source.substr(start));
+		starts.push_back(start);
+	}
+	lexers.resize(programs.size()); // each starts as nullptr
+	parsers.resize(programs.size());
+}
+
+// function to lex and parse a program from scratch
+// p	: index of the program
+void Incremental_Session::compile(int p)
+{
+	lexers[p].reset(new Lexer(programs[p])); // any old lexer and parser are freed
+	parsers[p].reset();
+	if(lexers[p]->numErrors == 0)
+		parsers[p].reset(new Parser(lexers[p]->tokQue, verbose));
+}
+
+// function to report a program's diagnostics, running semantic analysis on a copy of its CST
+// p	: index of the program
+void Incremental_Session::analyze(int p)
+{
+	cout << "[PROGRAM No. " << p+1 << "] [" << lexers[p]->numErrors << " lexical error(s) found.]"
+	<< " [" << lexers[p]->numWarnings << " lexical warning(s) found.]" << endl;
+	if(parsers[p] == nullptr) return;
+	cout << "[PROGRAM No. " << p+1 << "] [" << parsers[p]->numErrors << " parse error(s) found.]" << endl;
+	if(parsers[p]->numErrors > 0) return;
+	Node CST = parsers[p]->clone(parsers[p]->CST); // semantic analysis consumes the tree it walks
+	vector<queue<Node>*> queues; // the copy's child queues, gathered before analysis empties them
+	collect(CST, queues);
+	Semantic_Analyzer semantics(CST, verbose);
+	cout << "[PROGRAM No. " << p+1 << "] [" << semantics.numErrors << " semantic error(s) found.]"
+	<< " [" << semantics.numWarn << " semantic warning(s) found.]" << endl;
+	for(vector<queue<Node>*>::iterator it = queues.begin(); it != queues.end(); ++it)
+		delete *it; // free the copy
+}
+
+// function to gather the child queues of a tree
+// n		: the root of the tree
+// queues	: where to gather them
+void Incremental_Session::collect(Node& n, vector<queue<Node>*>& queues)
+{
+	queues.push_back(n.children);
+	queue<Node> children = *n.children; // shallow copy to walk through
+	while(!children.empty())
+	{
+		collect(children.front(), queues);
+		children.pop();
+	}
+}
@@ -1,6 +1,7 @@
 using namespace std;
 using std::string;
 using std::queue;
+using std::vector;
 
 // the Token structure
 typedef struct Token
@@ -8,6 +9,9 @@ typedef struct Token
 	string value;	// the value of this token
 	string name;	// the name of this token
 	int lineNum;	// the line number this token is on
+	int end;		// offset in the source just past this token (where scanning resumes)
+	bool clean;		// true if the lexer can restart scanning at end with a fresh state
+	bool charList;	// true if the lexer is inside a CharList after this token
 } Token;
 
 // the Lexer class object definition
@@ -17,37 +21,158 @@ class Lexer
 	public:
 		Lexer(string); // constructor
 		queue<Token> tokQue; // a quetor to hold all the resulting tokens
+		vector<Token> tokens; // every token of the program, kept so edits can be re-lexed incrementally
 		int numErrors; // the number of errors encountered while scanning
 		int numWarnings; // the numbers of warnings encountered while scanning
+		bool relex(int, int, string, int&, int&, int&, int&); // re-lexes only the tokens touched by a text edit
 	// private class access
 	private:
+		string source; // the source program being scanned
 		bool readingCharList; // variable to determine if we are in a CharList or not
 		bool warnEOF; // true if the user forgets the $ token
-		void addToken(queue<Token>&, string&, string, int, int&);
+		int lineNum; // the line number the lexer is currently on
+		int scan(int, bool, vector<Token>&, int, int);
+		void finish();
+		int findToken(int);
+		char charAt(int);
+		void addToken(vector<Token>&, string&, string, int, int&, int);
 		string getTokenName(string);
 };
 
 // the Lexer constructor
 // sourceFile	: the source program file the lexer should read from
 Lexer::Lexer(string sourceFile)
+{
+	source = sourceFile;
+	numErrors = 0; // start with no errors
+	warnEOF = true; // start off assuming EOF token has been omitted
+	numWarnings = 0;
+	lineNum = 1; // start on the first line
+	readingCharList = false; // true if the lexer should be reading a CharList
+	scan(0, true, tokens, -1, 0); // scan the whole program
+	finish(); // handle lex warnings
+	
+	// the parser reads tokens from a queue
+	for(vector<Token>::iterator it = tokens.begin(); it != tokens.end(); ++it)
+		tokQue.push(*it);
+}
+
+// function to re-lex a program after a text edit, reusing every token the edit cannot affect
+// scanning restarts at the last clean token boundary before the edit and stops as soon as
+// a clean boundary past the edit lines up with a clean boundary of the old token list
+// offset	: where the edit starts in the source
+// removed	: the number of characters the edit removes
+// inserted	: the text the edit inserts
+// &first	: set to the index of the first token that changed
+// &oldEnd	: set to the index just past the last changed token in the old token list
+// &newEnd	: set to the index just past the last changed token in the new token list
+// &lineDelta	: set to how many lines the text after the edit moved
+// returns	: true if the edit was re-lexed incrementally, false if the caller must lex the edited program from scratch
+bool Lexer::relex(int offset, int removed, string inserted, int& first, int& oldEnd, int& newEnd, int& lineDelta)
+{
+	if(numErrors > 0) return false; // erroneous token lists have no reliable boundaries
+	if(source.find('$', offset) < (string::size_type)(offset+removed) || inserted.find('$') != string::npos)
+		return false; // adding or removing the $ changes where the program ends
+	int lastLine = tokens.empty() ? 1 : tokens.back().lineNum; // line of the last token before the edit
+	if(warnEOF) tokens.pop_back(); // the added $ token is not part of the source
+	
+	// find the last clean boundary strictly before the edit, so any lookahead that
+	// decided the tokens before it is untouched by the edit as well
+	int restart = 0; // source offset to restart scanning from
+	first = 0; // index of the first re-lexed token
+	lineNum = 1;
+	readingCharList = false;
+	for(int i = findToken(offset)-1; i >= 0; --i)
+	{
+		if(tokens[i].clean)
+		{
+			restart = tokens[i].end;
+			first = i+1;
+			lineNum = tokens[i].lineNum;
+			readingCharList = tokens[i].charList;
+			break;
+		}
+	}
+	
+	// apply the edit to the source, counting the lines it adds and removes
+	lineDelta = 0; // how many lines the text after the edit moved
+	for(int i = 0; i < removed; ++i)
+		if(source.at(offset+i) == '\n' || source.at(offset+i) == '\r') --lineDelta;
+	for(string::size_type i = 0; i < inserted.length(); ++i)
+		if(inserted.at(i) == '\n' || inserted.at(i) == '\r') ++lineDelta;
+	source.replace(offset, removed, inserted);
+	int delta = inserted.length() - removed; // how far the text after the edit moved
+	
+	// re-lex from the restart point until the new tokens re-synchronize with the old ones
+	vector<Token> fresh; // the re-lexed tokens
+	int synced = scan(restart, false, fresh, offset+inserted.length(), delta);
+	if(numErrors > 0) return false; // the edit introduced a lexical error - a full lex will report it
+	if(synced >= 0) lineNum = lastLine + lineDelta; // the scan would have ended on the old last line, moved
+	int lead = first; // index of the first re-lexed token
+	oldEnd = (synced >= 0) ? synced+1 : tokens.size();
+	newEnd = first + fresh.size();
+	
+	// narrow the changed range to the tokens that really differ, so the parser rebuilds as little as possible
+	while(first < oldEnd && first < newEnd && tokens[first].name == fresh[first-lead].name &&
+		tokens[first].value == fresh[first-lead].value && tokens[first].lineNum == fresh[first-lead].lineNum)
+		++first;
+	while(oldEnd > first && newEnd > first && tokens[oldEnd-1].name == fresh[newEnd-1-lead].name &&
+		tokens[oldEnd-1].value == fresh[newEnd-1-lead].value && tokens[oldEnd-1].lineNum + lineDelta == fresh[newEnd-1-lead].lineNum)
+	{
+		--oldEnd;
+		--newEnd;
+	}
+	
+	// splice the re-lexed tokens in, moving the reused tail to its new position
+	int tail = (synced >= 0) ? synced+1 : tokens.size(); // first reused old token
+	for(int i = tail; i < (int)tokens.size(); ++i)
+	{
+		tokens[i].end += delta;
+		tokens[i].lineNum += lineDelta;
+	}
+	tokens.erase(tokens.begin()+lead, tokens.begin()+tail);
+	tokens.insert(tokens.begin()+lead, fresh.begin(), fresh.end());
+	
+	numWarnings = 0;
+	finish(); // re-add the $ token if it is still missing
+	return true;
+}
+
+// function to find a token by its end offset
+// end		: the offset to look for
+// returns	: the index of the first token ending at or after end
+int Lexer::findToken(int end)
+{
+	int low = 0;
+	int high = tokens.size();
+	while(low < high) // binary search, since tokens end in source order
+	{
+		int mid = (low + high) / 2;
+		if(tokens[mid].end < end) low = mid+1;
+		else high = mid;
+	}
+	return low;
+}
+
+// function to scan the source into tokens
+// pos		: the offset in the source to start scanning from
+// report	: true if errors should be printed as they are found
+// &toks	: the list to append the tokens to
+// syncFrom	: the offset from which to look for a boundary shared with the old token list, or -1 to scan to the end
+// delta	: how far the source after the edit moved
+// returns	: the index of the old token the scan re-synchronized on, or -1 if it scanned to the end
+int Lexer::scan(int pos, bool report, vector<Token>& toks, int syncFrom, int delta)
 {
 	// program input variables
-	stringstream source; // string stream to read from the source program
-	source.str(sourceFile);
-	// string input; // stores what is being fed into this program from a string stream
-	char next = source.get(); // the next character in the input stream
+	char next = charAt(pos); // the next character in the input stream
 	
 	// other important variables
-	int lineNum = 1; // the line number the parser is currently on
 	int i = 0; // holder for the number to correspond with each valid character for matrix traversal
 	int state = 0; // the current DFA state
 	string tokVal = ""; // variable to hold the value of tokens found while parsing
-	numErrors = 0; // start with no errors
-	warnEOF = true; // start off assuming EOF token has been omitted
-	numWarnings = 0;
 	
 	// transition table for the DFA
-	int transitionTable [31][45] = // characters x states
+	static const int transitionTable [31][45] = // characters x states
 	{
 		{1,24,1,1,1,15,1,1,3,1,1,1,1,1,1,5,1,1,10,18,1,1,20,1,1,1,2,2,2,2,2,2,2,2,2,2,30,30,30,30,30,30,30,4,9}, // State : 0
 		{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // State : 1
@@ -86,7 +211,6 @@ Lexer::Lexer(string sourceFile)
 	// static casting to correct Microsoft VS 2013 compiler istream to bool conversion error
 	//bool loop = static_cast<bool> (source.get(next)); 
 	
-	readingCharList = false; // true if the lexer should be reading a CharList
 	while(next != EOF)
 	{
 		// cout << next;
@@ -235,7 +359,7 @@ Lexer::Lexer(string sourceFile)
 			case '\r': // carriage return (newline)
 				if(readingCharList) // newlines not allowed in CharLists
 				{
-					cout << "[ERROR]Line " << lineNum << ": " << "The newline character is not a valid character token." << endl;
+					if(report) cout << "[ERROR]Line " << lineNum << ": " << "The newline character is not a valid character token." << endl;
 					++numErrors; // increment the number of errors found
 				}
 				newline = true;
@@ -243,8 +367,7 @@ Lexer::Lexer(string sourceFile)
 			case ' ':
 				if(!readingCharList) // is this space not part of a CharList?
 				{
-					//loop = static_cast<bool> (source.get(next)); // go on to the next character
-					next = source.get();
+					next = charAt(++pos); // go on to the next character
 					continue; // jump to the end of this loop iteration
 				}
 				// this space IS part of a CharList
@@ -253,12 +376,11 @@ Lexer::Lexer(string sourceFile)
 			case '\t':
 				if(readingCharList) // tabs not allowed in CharLists
 				{
-					cout << "[ERROR]Line " << lineNum << ": " << "The tab character is not a valid character token." << endl;
+					if(report) cout << "[ERROR]Line " << lineNum << ": " << "The tab character is not a valid character token." << endl;
 					++numErrors; // increment the number of errors found
 					error = true;
 				}
-				//loop = static_cast<bool> (source.get(next)); // go on to the next character
-				next = source.get();
+				next = charAt(++pos); // go on to the next character
 				continue; // jump to the end of this loop iteration
 				break;
 			default:
@@ -278,12 +400,11 @@ Lexer::Lexer(string sourceFile)
 		switch(state)
 		{
 			case 0: // we arrive here either due to the start of a new token or an error being found
-				int max; // number of characters to loop through in tokVal
+				string::size_type max; // number of characters to loop through in tokVal
 				if(tokVal.size() == 1) 
 				{
 					max = 1; // iterate once if there is only one character in tokVal
-					//loop = static_cast<bool> (source.get(next)); // go on to the next character
-					next = source.get();
+					next = charAt(++pos); // go on to the next character
 				}
 				else 
 					max = tokVal.size()-1; // iterate through this loop for every character in tokVal except the last
@@ -301,8 +422,10 @@ Lexer::Lexer(string sourceFile)
 						if(c == '=') name = "T_ASSIGN";
 						else if(c == ' ') name = "T_SPACE";
 						else name = "T_ID";
-						Token tok = {s, name, lineNum}; // create a new token
-						tokQue.push(tok); // append token to the token quetor
+						// create a new token, scanning resumes at the character that ended this run,
+						// and only the last character of the run ends at a fresh state
+						Token tok = {s, name, lineNum, pos, j + 1 == max, readingCharList};
+						toks.push_back(tok); // append token to the token list
 					}
 					else if(c == '\n' || c == '\r') // new line 
 					{
@@ -311,68 +434,86 @@ Lexer::Lexer(string sourceFile)
 					}					
 					else
 					{
-						cout << "[ERROR]Line " << lineNum << ": " << c << " is not a valid lexeme." << endl;
+						if(report) cout << "[ERROR]Line " << lineNum << ": " << c << " is not a valid lexeme." << endl;
 						++numErrors; // increment the number of errors found
 					}
 				}
 				tokVal = ""; // reset the token name
-				continue; // jump to the end of this loop iteration
 				break;
 			case 1: // this state means we've found an id
 				// cout << "Definite id " << tokVal << endl;
-				addToken(tokQue, tokVal, "T_ID", lineNum, state);
+				addToken(toks, tokVal, "T_ID", lineNum, state, pos+1);
+				next = charAt(++pos); // go on to the next character
 				break;
 			case 2: // this state means we've found an integer
 				// cout << "Definite integer " << tokVal << endl;
-				addToken(tokQue, tokVal, "T_DIGIT", lineNum, state);
+				addToken(toks, tokVal, "T_DIGIT", lineNum, state, pos+1);
+				next = charAt(++pos); // go on to the next character
 				break;
 			case 30: // this state means we've found a reserve word (e.g. print)
 				// cout << "Definite reserved word " << tokVal << endl;
-				addToken(tokQue, tokVal, getTokenName(tokVal), lineNum, state);
+				addToken(toks, tokVal, getTokenName(tokVal), lineNum, state, pos+1);
+				next = charAt(++pos); // go on to the next character
 				break;
 			default:
 				// do nothing - we are not in an accepting state
-				break;
+				next = charAt(++pos); // go on to the next character
+				continue; // no token boundary was reached
+		}
+		
+		// when re-lexing, stop once a clean boundary past the edit matches a clean boundary of the old tokens
+		if(syncFrom >= 0 && !toks.empty() && toks.back().clean && toks.back().end >= syncFrom && toks.back().end == pos)
+		{
+			Token& last = toks.back();
+			for(int k = findToken(last.end - delta); k < (int)tokens.size() && tokens[k].end == last.end - delta; ++k)
+			{
+				Token& o = tokens[k];
+				if(o.clean && o.charList == last.charList)
+					return k; // everything after old token k lexes exactly as before
+			}
 		}
-		//loop = static_cast<bool> (source.get(next)); // go on to the next character
-		next = source.get();
 	}
-	
-	// handle lex warnings
+	return -1; // scanned to the end of the source
+}
+
+// function to handle lex warnings
+void Lexer::finish()
+{
 	if(warnEOF) // forgot $
 	{
-		Token tok = {"$", "T_EOF", lineNum}; // create a new EOF token
-		tokQue.push(tok); // append token to the token quetor
+		Token tok = {"$", "T_EOF", lineNum, (int)source.length(), false, false}; // create a new EOF token
+		tokens.push_back(tok); // append token to the token list
 		cout << endl << "[WARN]Line " << lineNum << ": Programs must include the End of File character $. It has been added to the token list for parsing." << endl; // warn user
 		++numWarnings; // increment number of warnings
 	}
-	else
+	else if(!tokens.empty() && tokens.back().name != "T_EOF") // EOF token exists, but not at end
 	{
-		queue<Token> temp = tokQue;
-		Token lastTok;
-		while(!temp.empty())
-		{
-			lastTok = temp.front(); // will eventually become the last token in the queue
-			temp.pop();
-		}
-		if(lastTok.name != "T_EOF") // EOF token exists, but not at end
-		{
-			cout << endl << "[WARN]Line " << lastTok.lineNum << ": End of File character $ found, but not at the end of program. Be aware any code after the $ will not be compiled." << endl; // warn user
-			++numWarnings; // increment number of warnings
-		}
+		Token& lastTok = tokens.back(); // the last token in the list
+		cout << endl << "[WARN]Line " << lastTok.lineNum << ": End of File character $ found, but not at the end of program. Be aware any code after the $ will not be compiled." << endl; // warn user
+		++numWarnings; // increment number of warnings
 	}
 }
 
+// function to read a character from the source
+// pos		: the offset of the character
+// returns	: the character, or EOF past the end of the source
+char Lexer::charAt(int pos)
+{
+	if(pos < (int)source.length()) return source[pos];
+	return EOF;
+}
+
 // function to add a token to the token quetor
-// tokQue	: the token quetor, to add tokens to
+// toks		: the token list, to add tokens to
 // tokVal	: the value of the token, passed by reference for manipulation
 // tokName	: the name of the token
 // lineNum	: the current line number we are scanning
 // state	: the current state, to be set to 0
-void Lexer::addToken(queue<Token>& tokQue, string& tokVal, string tokName, int lineNum, int& state)
+// end		: the offset in the source just past the token
+void Lexer::addToken(vector<Token>& toks, string& tokVal, string tokName, int lineNum, int& state, int end)
 {
-	Token tok = {tokVal, tokName, lineNum};
-	tokQue.push(tok); // push the token to the back of the token quetor
+	Token tok = {tokVal, tokName, lineNum, end, true, readingCharList}; // accepting states never look past the token, so it ends clean
+	toks.push_back(tok); // push the token to the back of the token list
 	tokVal = ""; // reset the token name
 	state = 0; // reset the state
 }
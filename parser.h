@@ -1,25 +1,104 @@
 using namespace std;
 using std::string;
 using std::queue;
+using std::vector;
+
+// the kinds of nodes in the concrete and abstract syntax trees
+enum Kind
+{
+	// nonterminals of the grammar
+	N_PROGRAM, N_BLOCK, N_STATEMENT_LIST, N_STATEMENT, N_PRINT_STATEMENT, N_ASSIGNMENT_STATEMENT, N_VAR_DECL,
+	N_WHILE_STATEMENT, N_IF_STATEMENT, N_TYPE, N_EXPR, N_INT_EXPR, N_STRING_EXPR, N_BOOLEAN_EXPR, N_BOOLOP,
+	N_CHAR_LIST, N_BOOLVAL,
+	// terminals of the grammar
+	N_EOF, N_PLUS, N_ASSIGN, N_OPEN_BRACE, N_CLOSE_BRACE, N_OPEN_PAREN, N_CLOSE_PAREN, N_QUOTE, N_EQUALS,
+	N_NOT_EQUALS, N_FALSE, N_TRUE, N_WHILE, N_PRINT, N_STRING, N_BOOLEAN, N_INT, N_IF, N_SPACE, N_EPSILON,
+	// terminals whose payload is kept in the node's value
+	N_ID, N_DIGIT, N_CHARS,
+	// operators that only appear in the AST
+	N_ADD, N_EQUAL, N_NOT_EQUAL
+};
+
+// the types associated with nodes
+enum Type
+{
+	TYPE_VOID, TYPE_INT, TYPE_STRING, TYPE_BOOLEAN,
+	TYPE_ID // an id whose type is not yet known
+};
 
 // the CST node structure
 typedef struct Node
 {
-	string name; // the name of this node
-	string type; // the type associated with this node	
+	Kind kind; // the kind of this node
+	int value; // the letter of an id, the number of a digit, or the index of a string literal in the AST
+	string text; // the characters of a string literal (only for N_CHARS in the CST)
+	Type type; // the type associated with this node
 	int scope; // the scope associated with this node
 	int lineNum;
 	queue<Node>* children; // a queue containing the child nodes
 } Node;
 
+// function to get the name a kind of node has always been printed with
+// kind		: the kind of node
+// value	: the letter of an id or the number of a digit
+// text		: the characters of a string literal
+// returns	: the name, e.g. <Block>, [a], [5] or ["foo"]
+string kindName(Kind kind, int value, string text)
+{
+	static const string names[] = {
+		"<Program>", "<Block>", "<StatementList>", "<Statement>", "<PrintStatement>", "<AssignmentStatement>", "<VarDecl>",
+		"<WhileStatement>", "<IfStatement>", "<type>", "<Expr>", "<IntExpr>", "<StringExpr>", "<BooleanExpr>", "<boolop>",
+		"<CharList>", "<boolval>",
+		"[$]", "[+]", "[=]", "[{]", "[}]", "[(]", "[)]", "[\"]", "[==]",
+		"[!=]", "[false]", "[true]", "[while]", "[print]", "[string]", "[boolean]", "[int]", "[if]", "[space]", "[epsilon]",
+		"", "", "",
+		"<+>", "<==>", "<!=>"
+	};
+	switch(kind)
+	{
+		case N_ID:
+			return "[" + string(1, (char)value) + "]";
+		case N_DIGIT:
+			return "[" + to_string(value) + "]";
+		case N_CHARS:
+			return "[\"" + text + "\"]";
+		default:
+			return names[kind];
+	}
+}
+
+// function to get the name of a type
+// type		: the type
+// returns	: the name, e.g. int
+string typeName(Type type)
+{
+	static const string names[] = {"void", "int", "string", "boolean", "id"};
+	return names[type];
+}
+
+// a <Statement> or <Block> of the CST and the range of tokens it was parsed from,
+// kept so an edit only has to reparse the smallest one enclosing it
+typedef struct Span
+{
+	queue<Node>* node; // the child nodes of the <Statement> or <Block>
+	bool block; // true for a <Block>, false for a <Statement>
+	int start; // index of the first token
+	int end; // index just past the last token
+	vector<Span> inner; // the statements and blocks nested inside
+} Span;
+
 // the Parser class object definition
 class Parser
 {
 	// public class access
 	public:
 		Parser(queue<Token>&, bool); // constructor
+		Parser(const Parser&) = delete; // the parser owns the child queues it makes, so it is never copied
+		~Parser(); // destructor
 		int numErrors; // number of parser errors
 		Node CST; // the concrete syntax tree
+		bool reparse(vector<Token>&, int, int, int, int); // reparses only the subtree an edit touched
+		Node clone(Node&); // deep copies a tree so later phases can consume it
 	// private class access
 	private:
 		string error; // the error message to return
@@ -28,9 +107,18 @@ class Parser
 		int errorLine; // line number of the error
 		int stmtErrorLine; // line number of statement error
 		bool charList; // true if we are inside a charList
+		Span outline; // token ranges of every statement and block, rooted at the program's block
+		vector<Span> pending; // spans parsed so far that are not yet nested in their parent
+		int tokBase; // index of the first token in the queue being parsed
+		int tokTotal; // number of tokens in the queue being parsed
+		vector<queue<Node>*> made; // every child queue made, including those of subtrees a failed or repeated parse dropped
+		int tokIndex(queue<Token>&);
+		void addSpan(Node&, bool, int, queue<Token>&, int);
+		void shiftSpan(Span&, int);
+		void shiftLines(queue<Node>&, int);
 		Token hpop(queue<Token>&);
-		Node nmake(string);
-		Node nmake(string, int);
+		Node nmake(Kind);
+		Node nmake(Kind, int);
 		void printCST(Node, int);
 		bool parseProgram(queue<Token>&);
 		bool parseBlock(queue<Token> &, queue<Node>&);
@@ -80,8 +168,13 @@ Parser::Parser(queue<Token>& que, bool v)
 	numErrors = 0; // no errors at the start
 	error = ""; // set error to nothing
 	stmtError= ""; // set statement error to nothing
+	errorLine = 0; // no error line yet
+	stmtErrorLine = 0; // no statement error line yet
+	charList = false; // not inside a charList at the start
 	verbose = v; // should verbose output happen?
-	CST = nmake("<Program>"); // make root node of the CST
+	tokBase = 0; // the queue holds the whole program
+	tokTotal = que.size();
+	CST = nmake(N_PROGRAM); // make root node of the CST
 	if (!parseProgram(que))
 	{
 		if(stmtError != "") // if there was a semi-successful statement
@@ -92,6 +185,7 @@ Parser::Parser(queue<Token>& que, bool v)
 		cout << "[ERROR]Line " << errorLine << ": " << error << endl; // report the error
 		++numErrors; // increment the number of parser errors
 	}
+	else outline = pending.back(); // the program's block encloses every other span
 	if(verbose) // if verbose mode is on
 	{
 		cout <<
@@ -103,6 +197,14 @@ Parser::Parser(queue<Token>& que, bool v)
 	}
 }
 
+// the Parser destructor
+// frees every child queue the parser made, which covers the CST along with anything dropped while parsing
+Parser::~Parser()
+{
+	for(vector<queue<Node>*>::iterator it = made.begin(); it != made.end(); ++it)
+		delete *it;
+}
+
 // UTILITY FUNCTIONS
 	
 // function for returning the head of a token queue by popping it off; the queue then becomes its tail
@@ -116,24 +218,26 @@ Token Parser::hpop(queue<Token>& que)
 }
 
 // function to make a node
-// name		: name of this node
+// kind		: kind of this node
 // lineNum	: line number this node is accoaited with
 // returns	: a node
-Node Parser::nmake(string name)
+Node Parser::nmake(Kind kind)
 {
 	queue<Node>* children = new queue<Node>;
-	Node n = {name, "void", 0, 0, children}; // initialize with type void and scope 0 to be changed during AST creation
+	made.push_back(children); // freed with the parser
+	Node n = {kind, 0, "", TYPE_VOID, 0, 0, children}; // initialize with type void and scope 0 to be changed during AST creation
 	return n;
 }
 
 // function to make a node where the line number is specified
-// name		: name of this node
+// kind		: kind of this node
 // lineNum	: line number this node is accoaited with
 // returns	: a node
-Node Parser::nmake(string name, int lineNum)
+Node Parser::nmake(Kind kind, int lineNum)
 {
 	queue<Node>* children = new queue<Node>;
-	Node n = {name, "void", 0, lineNum, children}; // initialize with type void and scope 0 to be changed during AST creation
+	made.push_back(children); // freed with the parser
+	Node n = {kind, 0, "", TYPE_VOID, 0, lineNum, children}; // initialize with type void and scope 0 to be changed during AST creation
 	return n;
 }
 
@@ -144,7 +248,7 @@ void Parser::printCST(Node n, int level)
 {
 	for(int i=0; i < level; ++i) // for the node's depth
 		cout << "-"; // print out a corresponding number of dashes
-	cout << n.name << endl; // print node's name
+	cout << kindName(n.kind, n.value, n.text) << endl; // print node's name
 	queue<Node> children = *n.children; // get the node's children
 	while(!children.empty()) // for each child node
 	{
@@ -153,6 +257,147 @@ void Parser::printCST(Node n, int level)
 	}
 }
 
+// function to reparse a program after its tokens were re-lexed, rebuilding only the innermost
+// <Statement> or <Block> that encloses the changed tokens and reusing every other subtree
+// &tokens		: the program's tokens after the edit
+// first		: index of the first changed token
+// oldEnd		: index just past the last changed token before the edit
+// newEnd		: index just past the last changed token after the edit
+// lineDelta	: how many lines the tokens after the edit moved
+// returns		: true if the edit was reparsed in place, false if the caller must parse from scratch
+bool Parser::reparse(vector<Token>& tokens, int first, int oldEnd, int newEnd, int lineDelta)
+{
+	if(numErrors > 0) return false; // there is no reliable tree to reuse
+	if(first < outline.start || oldEnd > outline.end) return false; // the edit is outside the program's block
+	int delta = newEnd - oldEnd; // how far the tokens after the edit moved
+	
+	// find the chain of spans enclosing the changed tokens, outermost first
+	vector<Span*> path;
+	Span* span = &outline;
+	while(span != nullptr)
+	{
+		path.push_back(span);
+		Span* enclosing = nullptr;
+		for(vector<Span>::iterator it = span->inner.begin(); it != span->inner.end(); ++it)
+		{
+			if(it->start <= first && oldEnd <= it->end)
+			{
+				enclosing = &*it;
+				break;
+			}
+		}
+		span = enclosing;
+	}
+	
+	// try the innermost span first, moving outwards until one parses to exactly its new tokens
+	for(int i = path.size()-1; i >= 0; --i)
+	{
+		Span& target = *path[i];
+		queue<Token> que; // the span's tokens after the edit
+		for(int t = target.start; t < target.end + delta; ++t)
+			que.push(tokens[t]);
+		Token stop = {"$", "T_EOF", 0, 0, false, false}; // no statement or block can consume this, so the parse stops at the end of the span
+		que.push(stop);
+		tokBase = target.start;
+		tokTotal = que.size();
+		pending.clear();
+		queue<Node> nodes; // the reparsed subtree
+		bool parsed = target.block ? parseBlock(que, nodes) : parseStatement(que, nodes);
+		if(!parsed || que.size() != 1) continue; // the edit changed the structure around this span
+		
+		// splice the new subtree into the old node so its parents are untouched
+		*target.node = *nodes.front().children;
+		Span rebuilt = pending.back();
+		rebuilt.node = target.node;
+		
+		// move everything after the edit in the enclosing spans
+		for(int a = 0; a < i; ++a)
+		{
+			Span& outer = *path[a];
+			outer.end += delta;
+			if(outer.block) outer.node->back().lineNum += lineDelta; // the block's [}]
+			int after = path[a+1] - &outer.inner[0] + 1; // first span following the edited one
+			for(vector<Span>::iterator it = outer.inner.begin()+after; it != outer.inner.end(); ++it)
+			{
+				shiftSpan(*it, delta);
+				if(lineDelta != 0) shiftLines(*it->node, lineDelta);
+			}
+		}
+		CST.children->back().lineNum += lineDelta; // the program's [$]
+		target = rebuilt;
+		return true;
+	}
+	return false;
+}
+
+// function to deep copy a tree, since later phases consume the child queues they walk
+// n		: the root of the tree to copy
+// returns	: the copy
+Node Parser::clone(Node& n)
+{
+	Node copy = n;
+	copy.children = new queue<Node>;
+	queue<Node> children = *n.children; // shallow copy to walk through
+	while(!children.empty())
+	{
+		copy.children->push(clone(children.front()));
+		children.pop();
+	}
+	return copy;
+}
+
+// function to get the index of the head of a token queue within the program's tokens
+// que		: the token queue being parsed
+// returns	: the index of its head token
+int Parser::tokIndex(queue<Token>& que)
+{
+	return tokBase + tokTotal - que.size();
+}
+
+// function to record the tokens a successfully parsed statement or block spans
+// n		: the <Statement> or <Block> node
+// block	: true if n is a <Block>
+// start	: index of its first token
+// que		: the token queue, now just past its last token
+// mark		: number of pending spans before it was parsed; the rest are nested inside it
+void Parser::addSpan(Node& n, bool block, int start, queue<Token>& que, int mark)
+{
+	Span s;
+	s.node = n.children;
+	s.block = block;
+	s.start = start;
+	s.end = tokIndex(que);
+	s.inner.assign(pending.begin()+mark, pending.end());
+	pending.resize(mark);
+	pending.push_back(s);
+}
+
+// function to move a span and everything nested in it to later tokens
+// &s		: the span
+// delta	: how many tokens to move it by
+void Parser::shiftSpan(Span& s, int delta)
+{
+	s.start += delta;
+	s.end += delta;
+	for(vector<Span>::iterator it = s.inner.begin(); it != s.inner.end(); ++it)
+		shiftSpan(*it, delta);
+}
+
+// function to move the line numbers of a subtree
+// &nodes		: the child nodes to move
+// lineDelta	: how many lines to move them by
+void Parser::shiftLines(queue<Node>& nodes, int lineDelta)
+{
+	for(int i = nodes.size(); i > 0; --i) // rotate through the queue once
+	{
+		Node n = nodes.front();
+		nodes.pop();
+		if(n.lineNum > 0) n.lineNum += lineDelta; // only token nodes carry line numbers
+		shiftLines(*n.children, lineDelta);
+		nodes.push(n);
+	}
+}
+
 // PARSE FUNCTIONS
 
 bool Parser::parseProgram(queue<Token>& que)
@@ -166,16 +411,20 @@ bool Parser::parseProgram(queue<Token>& que)
 bool Parser::parseBlock(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseBlock" << endl;
-	Node n = nmake("<Block>");
+	Node n = nmake(N_BLOCK);
 	queue<Token> savedQue = que; // save queue for reverting since epsilon is involved
+	int start = tokIndex(que); // first token of the block, for incremental reparsing
+	int mark = pending.size(); // spans parsed inside this block come after this
 	if(matchT_OPEN_BRACE(hpop(que), *n.children) && 
 		parseStatementList(que, *n.children) && 
 		matchT_CLOSE_BRACE(hpop(que), *n.children)
 		)
 	{
 		nodes.push(n);
+		addSpan(n, true, start, que, mark);
 		return true;
 	}
+	pending.resize(mark);
 	que = savedQue;
 	return false;	
 }
@@ -183,7 +432,7 @@ bool Parser::parseBlock(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseStatementList(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parsStmtLst" << endl;
-	Node n = nmake("<StatementList>");
+	Node n = nmake(N_STATEMENT_LIST);
 	queue<Token> savedQue = que; // save queue for reverting since epsilon is involved
 	if(parseStatement(que, *n.children))
 	{
@@ -197,7 +446,7 @@ bool Parser::parseStatementList(queue<Token>& que, queue<Node>& nodes)
 	{
 		// epsilon
 		que = savedQue;
-		Node e = nmake("[epsilon]");
+		Node e = nmake(N_EPSILON);
 		queue<Node>& children = *n.children;
 		children.push(e);
 		nodes.push(n);
@@ -209,11 +458,14 @@ bool Parser::parseStatementList(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseStatement(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseStmt" << endl;
-	Node n = nmake("<Statement>");
+	Node n = nmake(N_STATEMENT);
 	queue<Token> savedQue = que; // save queue for reverting since multiple paths are involved
+	int start = tokIndex(que); // first token of the statement, for incremental reparsing
+	int mark = pending.size(); // spans parsed inside this statement come after this
 	if (parsePrintStatement(que, *n.children))
 	{		
 		nodes.push(n);
+		addSpan(n, false, start, que, mark);
 		return true; 
 	}
 	else 
@@ -221,6 +473,7 @@ bool Parser::parseStatement(queue<Token>& que, queue<Node>& nodes)
 	if (parseAssignmentStatement(que, *n.children)) 
 	{		
 		nodes.push(n);
+		addSpan(n, false, start, que, mark);
 		return true; 
 	} 
 	else 
@@ -228,6 +481,7 @@ bool Parser::parseStatement(queue<Token>& que, queue<Node>& nodes)
 	if (parseIfStatement(que, *n.children)) 
 	{		
 		nodes.push(n);
+		addSpan(n, false, start, que, mark);
 		return true; 
 	}
 	else 
@@ -235,6 +489,7 @@ bool Parser::parseStatement(queue<Token>& que, queue<Node>& nodes)
 	if (parseWhileStatement(que, *n.children)) 
 	{		
 		nodes.push(n);
+		addSpan(n, false, start, que, mark);
 		return true; 
 	} 
 	else 
@@ -242,6 +497,7 @@ bool Parser::parseStatement(queue<Token>& que, queue<Node>& nodes)
 	if (parseVarDecl(que, *n.children)) 
 	{		
 		nodes.push(n);
+		addSpan(n, false, start, que, mark);
 		return true; 
 	} 
 	else 
@@ -249,17 +505,19 @@ bool Parser::parseStatement(queue<Token>& que, queue<Node>& nodes)
 	if (parseBlock(que, *n.children)) 
 	{		
 		nodes.push(n);
+		addSpan(n, false, start, que, mark);
 		return true; 
 	} 
 	else 
 		que = savedQue;
+	pending.resize(mark);
 	return false;
 }
 
 bool Parser::parsePrintStatement(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parsePrintStmt" << que.front().name << endl;
-	Node n = nmake("<PrintStatement>");
+	Node n = nmake(N_PRINT_STATEMENT);
 	queue<Token> savedQue = que; // save queue for reverting
 	if (matchT_PRINT(hpop(que), *n.children))
 	{
@@ -281,7 +539,7 @@ bool Parser::parsePrintStatement(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseAssignmentStatement(queue<Token>& que, queue<Node>& nodes)
 { 
 	// cout << "parseAssignStmt" << endl;
-	Node n = nmake("<AssignmentStatement>");
+	Node n = nmake(N_ASSIGNMENT_STATEMENT);
 	queue<Token> savedQue = que; // save queue for reverting
 	if(matchT_ID(hpop(que), *n.children))
 		if(matchT_ASSIGN(hpop(que), *n.children) && parseExpression(que, *n.children))
@@ -301,7 +559,7 @@ bool Parser::parseAssignmentStatement(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseVarDecl(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseVarDecl" << endl;
-	Node n = nmake("<VarDecl>");
+	Node n = nmake(N_VAR_DECL);
 	queue<Token> savedQue = que; // save queue for reverting
 	if(parseType(que, *n.children))
 		if(matchT_ID(hpop(que), *n.children))
@@ -321,7 +579,7 @@ bool Parser::parseVarDecl(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseWhileStatement(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseWhileStmt" << endl;
-	Node n = nmake("<WhileStatement>");
+	Node n = nmake(N_WHILE_STATEMENT);
 	queue<Token> savedQue = que; // save queue for reverting
 	if(matchT_WHILE(hpop(que), *n.children))
 		if(parseBooleanExpression(que, *n.children) && parseBlock(que, *n.children))
@@ -341,7 +599,7 @@ bool Parser::parseWhileStatement(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseIfStatement(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseIfStmt" << endl;
-	Node n = nmake("<IfStatement>");
+	Node n = nmake(N_IF_STATEMENT);
 	queue<Token> savedQue = que; // save queue for reverting
 	if(matchT_IF(hpop(que), *n.children))
 		if(parseBooleanExpression(que, *n.children) && parseBlock(que, *n.children))
@@ -361,7 +619,7 @@ bool Parser::parseIfStatement(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseType(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseType" << endl;
-	Node n = nmake("<type>");
+	Node n = nmake(N_TYPE);
 	queue<Token> savedQue = que; // save queue for reverting since multiple paths are involved
 	if (matchT_INT(hpop(que), *n.children))
 	{ 
@@ -387,7 +645,7 @@ bool Parser::parseType(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseExpression(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseExpr" << endl;
-	Node n = nmake("<Expr>");
+	Node n = nmake(N_EXPR);
 	queue<Token> savedQue = que; // save queue for reverting since multiple paths are involved
 	if (matchT_ID(hpop(que), *n.children))
 	{	
@@ -408,7 +666,7 @@ bool Parser::parseExpression(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseIntExpression(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseIntExpr" << endl;
-	Node n = nmake("<IntExpr>");
+	Node n = nmake(N_INT_EXPR);
 	queue<Token> savedQue = que; // save queue for reverting since multiple paths are involved
 	
 	if(matchT_DIGIT(hpop(que), *n.children))
@@ -434,7 +692,7 @@ bool Parser::parseIntExpression(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseStringExpression(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseStringExpr" << endl;
-	Node n = nmake("<StringExpr>");
+	Node n = nmake(N_STRING_EXPR);
 	queue<Token> savedQue = que; // save queue for reverting
 	if( matchT_QUOTE(hpop(que), *n.children) &&
 		parseCharList(que, *n.children) &&
@@ -451,7 +709,7 @@ bool Parser::parseStringExpression(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseBooleanExpression(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseBoolExpr" << endl;
-	Node n = nmake("<BooleanExpr>");
+	Node n = nmake(N_BOOLEAN_EXPR);
 	queue<Token> savedQue = que; // save queue for reverting since multiple paths are involved
 	if(matchT_OPEN_PAREN(hpop(que), *n.children) &&
 		parseExpression(que, *n.children) &&
@@ -478,7 +736,7 @@ bool Parser::parseBooleanExpression(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseBoolOp(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseBoolOp" << endl;
-	Node n = nmake("<boolop>");
+	Node n = nmake(N_BOOLOP);
 	queue<Token> savedQue = que; // save queue for reverting
 	Token tok = hpop(que); // only two paths here, each taking just the head token
 	if(matchT_EQUALS(tok, *n.children) ||
@@ -494,7 +752,7 @@ bool Parser::parseBoolOp(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseCharList(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseCharList" << endl;
-	Node n = nmake("<CharList>");
+	Node n = nmake(N_CHAR_LIST);
 	charList = true; // we are now inside a charList
 	queue<Token> savedQue = que; // save queue for reverting since epsilon is involved
 	Token tok = hpop(que); // get the head token
@@ -519,20 +777,21 @@ bool Parser::parseCharList(queue<Token>& que, queue<Node>& nodes)
 		charList = false; // exiting the charList
 		// convert characters and other valid keywords into a charList
 		queue<Node>& children = *n.children;
-		string s = "[\"";
+		Node s = nmake(N_CHARS); // the string literal
+		s.type = TYPE_STRING;
 		Node saved = nodes.front(); // save ["] node
-		int lineNum = saved.lineNum; // get line number of string literal
+		s.lineNum = saved.lineNum; // get line number of string literal
 		nodes.pop(); // get rid of ["] node
 		while(!nodes.empty())
 		{
 			Node head = nodes.front();
-			if(head.name == "[space]") s.append(" "); // convert [space] to actual space
-			else s.append(head.name.substr(1, head.name.length()-2)); // otherwise trim off [ and ]
+			string name = kindName(head.kind, head.value, "");
+			if(head.kind == N_SPACE) s.text.append(" "); // convert [space] to actual space
+			else s.text.append(name.substr(1, name.length()-2)); // otherwise trim off [ and ]
 			nodes.pop();
 		}
-		s.append("\"]");
 		nodes.push(saved); // put ["] back
-		children.push(nmake(s, lineNum));
+		children.push(s);
 		nodes.push(n); // push converted charList 
 	}
 	return true;
@@ -541,7 +800,7 @@ bool Parser::parseCharList(queue<Token>& que, queue<Node>& nodes)
 bool Parser::parseBoolval(queue<Token>& que, queue<Node>& nodes)
 {
 	// cout << "parseBoolVal" << endl;
-	Node n = nmake("<boolval>");
+	Node n = nmake(N_BOOLVAL);
 	queue<Token> savedQue = que; // save queue for reverting
 	Token tok = hpop(que); // only two paths here, each taking just the head token
 	if(matchT_TRUE(tok, *n.children) ||
@@ -559,13 +818,14 @@ bool Parser::parseBoolval(queue<Token>& que, queue<Node>& nodes)
 bool Parser::matchT_DIGIT(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match digit " << tok.value << endl;
-	Node n = nmake("["+tok.value+"]", tok.lineNum);
-	n.type = "digit";
+	Node n = nmake(N_DIGIT, tok.lineNum);
+	n.type = TYPE_INT;
 	error = "[" + tok.value + "] is not a valid digit. Valid digits include numbers [0-9].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_DIGIT")
 	{
 		// if(verbose) cout << "Matched a T_DIGIT." << endl;
+		n.value = tok.value.at(0) - 48; // the number of the digit
 		nodes.push(n);
 		return true;
 	}
@@ -575,8 +835,8 @@ bool Parser::matchT_DIGIT(Token tok, queue<Node>& nodes)
 bool Parser::matchT_ID(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match id " << tok.value << endl;
-	Node n = nmake("["+tok.value+"]", tok.lineNum);
-	n.type = "id";
+	Node n = nmake(N_ID, tok.lineNum);
+	n.type = TYPE_ID;
 	if(!charList ) 
 		error = "[" + tok.value + "] is not a valid identifier. Valid identifiers include lowercase letters [a-z].";
 	else 
@@ -585,6 +845,7 @@ bool Parser::matchT_ID(Token tok, queue<Node>& nodes)
 	if(tok.name == "T_ID")
 	{
 		// if(verbose) cout << "Matched a T_ID." << endl;
+		n.value = tok.value.at(0); // the letter of the id
 		nodes.push(n);
 		return true;
 	}
@@ -594,7 +855,7 @@ bool Parser::matchT_ID(Token tok, queue<Node>& nodes)
 bool Parser::matchT_EOF(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match eof " << tok.value << endl;
-	Node n = nmake("[$]", tok.lineNum);
+	Node n = nmake(N_EOF, tok.lineNum);
 	error = "Program cannot end with [" + tok.value + "]. Programs may only end with [$].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_EOF")
@@ -610,7 +871,7 @@ bool Parser::matchT_PLUS(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match plus " << tok.value << endl;
 	// no error message here isnce an integer expression can also be just a digit, which is checked second
-	Node n = nmake("[+]", tok.lineNum);
+	Node n = nmake(N_PLUS, tok.lineNum);
 	if(tok.name == "T_PLUS")
 	{
 		// if(verbose) cout << "Matched a T_PLUS." << endl;
@@ -623,7 +884,7 @@ bool Parser::matchT_PLUS(Token tok, queue<Node>& nodes)
 bool Parser::matchT_ASSIGN(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match assign " << tok.value << endl;
-	Node n = nmake("[=]", tok.lineNum);
+	Node n = nmake(N_ASSIGN, tok.lineNum);
 	error = "Expecting the assignment operator [=]. Instead found the token [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_ASSIGN")
@@ -638,7 +899,7 @@ bool Parser::matchT_ASSIGN(Token tok, queue<Node>& nodes)
 bool Parser::matchT_OPEN_BRACE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match open brace " << tok.value << endl;
-	Node n = nmake("[{]", tok.lineNum);
+	Node n = nmake(N_OPEN_BRACE, tok.lineNum);
 	error = "Expecting an open brace [{] before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_OPEN_BRACE")
@@ -653,7 +914,7 @@ bool Parser::matchT_OPEN_BRACE(Token tok, queue<Node>& nodes)
 bool Parser::matchT_CLOSE_BRACE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match close brace " << tok.value << endl;
-	Node n = nmake("[}]", tok.lineNum);
+	Node n = nmake(N_CLOSE_BRACE, tok.lineNum);
 	error = "Expecting a closing brace [}] before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_CLOSE_BRACE")
@@ -668,7 +929,7 @@ bool Parser::matchT_CLOSE_BRACE(Token tok, queue<Node>& nodes)
 bool Parser::matchT_OPEN_PAREN(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match open paren " << tok.value << endl;
-	Node n = nmake("[(]", tok.lineNum);
+	Node n = nmake(N_OPEN_PAREN, tok.lineNum);
 	error = "Expecting an open parenthesis [(] before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_OPEN_PAREN")
@@ -683,7 +944,7 @@ bool Parser::matchT_OPEN_PAREN(Token tok, queue<Node>& nodes)
 bool Parser::matchT_CLOSE_PAREN(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match close paren " << tok.value << endl;
-	Node n = nmake("[)]", tok.lineNum);
+	Node n = nmake(N_CLOSE_PAREN, tok.lineNum);
 	error = "Expecting a closing parenthesis [)] before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_CLOSE_PAREN")
@@ -698,7 +959,7 @@ bool Parser::matchT_CLOSE_PAREN(Token tok, queue<Node>& nodes)
 bool Parser::matchT_QUOTE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match quote " << tok.value << endl;
-	Node n = nmake("[\"]", tok.lineNum);
+	Node n = nmake(N_QUOTE, tok.lineNum);
 	error = "Strings must be wrapped in quotation marks. Expecting a quote [\"] before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_QUOTE")
@@ -713,7 +974,7 @@ bool Parser::matchT_QUOTE(Token tok, queue<Node>& nodes)
 bool Parser::matchT_EQUALS(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match equals " << tok.value << endl;
-	Node n = nmake("[==]", tok.lineNum);
+	Node n = nmake(N_EQUALS, tok.lineNum);
 	error = "[" + tok.value + "] is not a valid boolean operator. Valid boolean operators include [==] and [!=].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_EQUALS")
@@ -728,7 +989,7 @@ bool Parser::matchT_EQUALS(Token tok, queue<Node>& nodes)
 bool Parser::matchT_NOT_EQUALS(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match not equals " << tok.value << endl;
-	Node n = nmake("[!=]", tok.lineNum);
+	Node n = nmake(N_NOT_EQUALS, tok.lineNum);
 	error = "[" + tok.value + "] is not a valid boolean operator. Valid boolean operators include [==] and [!=].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_NOT_EQUALS")
@@ -743,7 +1004,7 @@ bool Parser::matchT_NOT_EQUALS(Token tok, queue<Node>& nodes)
 bool Parser::matchT_FALSE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match false " << tok.value << endl;
-	Node n = nmake("[false]", tok.lineNum);
+	Node n = nmake(N_FALSE, tok.lineNum);
 	error = "[" + tok.value + "] is not a valid boolean value. Valid boolean values include [true] and [false].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_FALSE")
@@ -758,7 +1019,7 @@ bool Parser::matchT_FALSE(Token tok, queue<Node>& nodes)
 bool Parser::matchT_TRUE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match true " << tok.value << endl;
-	Node n = nmake("[true]", tok.lineNum);
+	Node n = nmake(N_TRUE, tok.lineNum);
 	error = "[" + tok.value + "] is not a valid boolean value. Valid boolean values include [true] and [false].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_TRUE")
@@ -773,7 +1034,7 @@ bool Parser::matchT_TRUE(Token tok, queue<Node>& nodes)
 bool Parser::matchT_WHILE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match while " << tok.value << endl;
-	Node n = nmake("[while]", tok.lineNum);
+	Node n = nmake(N_WHILE, tok.lineNum);
 	error = "Expecting the [while] keyword before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_WHILE")
@@ -788,7 +1049,7 @@ bool Parser::matchT_WHILE(Token tok, queue<Node>& nodes)
 bool Parser::matchT_PRINT(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match print " << tok.value << endl;
-	Node n = nmake("[print]", tok.lineNum);
+	Node n = nmake(N_PRINT, tok.lineNum);
 	error = "Expecting the [print] keyword before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_PRINT")
@@ -803,7 +1064,7 @@ bool Parser::matchT_PRINT(Token tok, queue<Node>& nodes)
 bool Parser::matchT_STRING(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match string " << tok.value << endl;
-	Node n = nmake("[string]", tok.lineNum);
+	Node n = nmake(N_STRING, tok.lineNum);
 	error = "Expecting the [string] keyword before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_STRING")
@@ -818,7 +1079,7 @@ bool Parser::matchT_STRING(Token tok, queue<Node>& nodes)
 bool Parser::matchT_BOOLEAN(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match bool " << tok.value << endl;
-	Node n = nmake("[boolean]", tok.lineNum);
+	Node n = nmake(N_BOOLEAN, tok.lineNum);
 	error = "Expecting the [boolean] keyword before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_BOOLEAN")
@@ -833,7 +1094,7 @@ bool Parser::matchT_BOOLEAN(Token tok, queue<Node>& nodes)
 bool Parser::matchT_INT(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match int " << tok.value << endl;
-	Node n = nmake("[int]", tok.lineNum);
+	Node n = nmake(N_INT, tok.lineNum);
 	error = "Expecting the [int] keyword before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_INT")
@@ -848,7 +1109,7 @@ bool Parser::matchT_INT(Token tok, queue<Node>& nodes)
 bool Parser::matchT_IF(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match if " << tok.value << endl;
-	Node n = nmake("[if]", tok.lineNum);
+	Node n = nmake(N_IF, tok.lineNum);
 	error = "Expecting keyword [if] before the [" + tok.value + "].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_IF")
@@ -863,7 +1124,7 @@ bool Parser::matchT_IF(Token tok, queue<Node>& nodes)
 bool Parser::matchT_SPACE(Token tok, queue<Node>& nodes)
 {
 	// cout << "	match space " << tok.value << endl;
-	Node n = nmake("[space]", tok.lineNum);
+	Node n = nmake(N_SPACE, tok.lineNum);
 	error = "[" + tok.value + "] is not a valid character. Characters can only be lowercase letters [a-z] or the space character [ ].";
 	errorLine = tok.lineNum;
 	if(tok.name == "T_SPACE")
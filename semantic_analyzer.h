@@ -3,62 +3,88 @@ using std::string;
 using std::queue;
 using std::vector;
 using std::unordered_map;
+using std::map;
 
 // the Symbol structure (for the symbol table)
 typedef struct Symbol
 {
-	string name; // name of the symbol
-	string type; // the type of this symbol
+	int name; // the letter of the symbol
+	Type type; // the type of this symbol
 	int lineNum; // the line number this symbol is found on
-	int intVal; // integer value (set only if type=="int")
-	bool boolVal; // boolean value (set only if type=="boolean")
-	string stringVal; // string value (set only if type=="string")
+	int intVal; // integer value (set only if type==TYPE_INT)
+	bool boolVal; // boolean value (set only if type==TYPE_BOOLEAN)
+	string stringVal; // string value (set only if type==TYPE_STRING)
 	bool initialized; // default false; becomes true if symbol is initialized after declaration
 	bool used; // default false; becomes true if symbol is used after initialization
 	int scope; // scope of the symbol
 	int subscope; // for parallel scopes with same parent node
 } Symbol;
 
-// the structure for each node of the symbol table
+// the structure for each scope on the symbol table's scope stack
 typedef struct Table_Node
 {
 	int scope; // the scope of this piece of the symbol table
-	unordered_map<string, Symbol&> symbols; // symbol table hash map <id, symbol>
-	Table_Node* parent; // the enclosing scope
+	int slots[26]; // for each letter a-z, the slot of the symbol declared in this scope (-1 if none)
 } Table_Node;
 
 // the AST node structure
+// the AST is one flat array in pre-order: a node's first child directly follows it,
+// and each later child directly follows the subtree of the child before it
 typedef struct AST_Node
 {
-	string name; // the name of this node
-	string type; // the type associated with this node	
+	Kind kind; // the kind of this node
+	int value; // the letter of an id, the number of a digit, or the index of a string literal in strings
+	Type type; // the type associated with this node
 	int scope; // the scope associated with this node
 	int subscope; // the subscope associated with this node
+	int slot; // for an id, the slot of the symbol it refers to (-1 if unresolved)
 	int lineNum;
-	vector<AST_Node>* children; // a queue containing the child nodes
+	int numChildren; // the number of child nodes
+	int end; // index just past the last node of this node's subtree
 } AST_Node;
 
+// function to find a child of a node in the flat AST
+// &AST		: the AST
+// n		: index of the node
+// k		: which child to find, counting from 0
+// returns	: index of the child
+int childOf(vector<AST_Node>& AST, int n, int k)
+{
+	int c = n+1; // the first child directly follows its parent
+	for(; k > 0; --k) c = AST[c].end; // skip over the subtrees of earlier children
+	return c;
+}
+
 class Semantic_Analyzer
 {
 	// public class access
 	public:
 		Semantic_Analyzer(Node&, bool); // constructor
-		AST_Node AST; // the abstract syntax tree
+		vector<AST_Node> AST; // the abstract syntax tree, in pre-order with the root at index 0
 		int numErrors; // number of errors found
 		int numWarn; // number of warnings found
 		// <string, memory address> map to save all the string literals in for later code generation
-		// the memory addresses are not stored until later code generation
+		// until code generation stores the memory addresses, each string maps to its index in strings
 		unordered_map<string, int> stringsMap; 
+		vector<string> strings; // the string literals, indexed by the value of their AST nodes
+		vector<Symbol> symbols; // every declared symbol in order of declaration, indexed by its slot
 	// private class access
 	private:
 		bool verbose;
-		void constructAST(Node&, queue<Node>&, int);
-		AST_Node resolveTypes(Node&, queue<Node>&);
-		void constructSymbolTable(AST_Node&, Table_Node*, queue<Symbol*>&, int);
-		void printAST(AST_Node, int);
-		Node nmake(string, string, int, int);
-		void typeCheck(AST_Node&);
+		void analyze(Node&, int);
+		int emit(Kind, int, Type, int, int);
+		int close(int);
+		void typeCheck(int);
+		void declare(int, int);
+		void use(int);
+		int resolve(int);
+		void printAST();
+		string nodeName(AST_Node&);
 		unordered_map<int, int> scopeMap; // <scope, scubscope> map
+		vector<Table_Node> scopeStack; // the scopes enclosing the node being analyzed, innermost last
+		vector<int> open; // the AST nodes whose children are still being laid out, innermost last
+		bool resolving; // false while analyzing the right side of an assignment to an undeclared variable
+		map<int, string> typeErrors; // type errors by the index of the node they were found at
 };
 
 // constructor
@@ -67,38 +93,26 @@ Semantic_Analyzer::Semantic_Analyzer(Node& CST, bool v)
 	verbose = v;
 	numErrors = 0; // start with no errors, of course
 	numWarn = 0; // start with no warnings, of course
-	queue<Node> AST_queue;
-	constructAST(CST, AST_queue, 0);
-	if(!AST_queue.empty())
-	{
-		// resolves types, except for individual ids, while at the same time constructing a new AST using vectors instead of queues
-		AST = resolveTypes(AST_queue.front(), *AST_queue.front().children);
-	}
+	resolving = true; // start off checking every id
 	
-	// we'll need to store each symbol table node in this queue
-	// so we can iterate through it and print out all the symbols
-	// since iterating through a tree where pointers are to parent
-	// nodes instead of child nodes is a bit trickier
-	queue<Symbol*> symTblPrntQ; // symbol table print queue
-	constructSymbolTable(AST, nullptr, symTblPrntQ, 0); // construct the symbol table
-	queue<Symbol*> savedQ = symTblPrntQ; // save the queue for second traversal
-	
-	// type check
-	typeCheck(AST);
+	// lay out the AST, resolve scopes, infer and check types and track initialization and use, all in one walk over the CST
+	analyze(CST, 0);
+	// type errors are found as each node is finished, after its children, so print them in the order the tree reads
+	for(map<int, string>::iterator it = typeErrors.begin(); it != typeErrors.end(); ++it)
+		cout << it->second << endl;
 	
 	// traverse the table to warn about unused variables
-	while(!symTblPrntQ.empty())
+	for(vector<Symbol>::iterator it = symbols.begin(); it != symbols.end(); ++it)
 	{
-		Symbol sym = *symTblPrntQ.front();
+		Symbol& sym = *it;
 		// warn the user if a variable is never used
 		if(!sym.used)
 		{
 			string init = (sym.initialized) ? "initialized" : "uninitialized"; // is the variable at least initialized? modify the warning
 			cout << "[WARN]Line " << sym.lineNum << ": " << "The " << init << 
-			" variable " << sym.name << " is never used." << endl;
+			" variable " << kindName(N_ID, sym.name, "") << " is never used." << endl;
 			++numWarn;
 		}
-		symTblPrntQ.pop();
 	}
 	
 	if(verbose) // if verbose mode is on
@@ -108,21 +122,16 @@ Semantic_Analyzer::Semantic_Analyzer(Node& CST, bool v)
 			"______________________________________________________________________" << endl <<
 			setw(25) << left << "" << "ABSTRACT SYNTAX TREE" << setw(25) << right << "" << endl <<
 			"______________________________________________________________________" << endl;
-		printAST(AST, 0); // print the AST
+		printAST(); // print the AST
 		cout << "______________________________________________________________________" << endl;
 		// print symbol table
 		cout <<
 			"______________________________________________________________________" << endl <<
 			setw(29) << left << "" << "SYMBOL TABLE" << setw(29) << right << "" << endl <<
 			"______________________________________________________________________" << endl;
-		while(!savedQ.empty())
+		for(vector<Symbol>::iterator it = symbols.begin(); it != symbols.end(); ++it)
 		{
-			Symbol sym = *savedQ.front();
-			string type = sym.type;
-			// rename type so there are no square brackets
-			if(type == "[int]") type = "int";
-			else if(type == "[string]") type = "string";
-			else type = "boolean";
+			Symbol& sym = *it;
 			// math to get the scope to print out correctly in the symbol table
 			int i = 1;
 			int n = 10;
@@ -133,468 +142,435 @@ Semantic_Analyzer::Semantic_Analyzer(Node& CST, bool v)
 			}
 			// print out symbol table
 			cout << left <<
-				"[NAME: " << setw(5) << sym.name.substr(1,1) << "]" << 
-				"[TYPE: " << setw(10) << type << "]" << 
+				"[NAME: " << setw(5) << string(1, (char)sym.name) << "]" << 
+				"[TYPE: " << setw(10) << typeName(sym.type) << "]" << 
 				"[SCOPE: " << setw(i) << sym.scope << "-" << setw(11-i) << sym.subscope << "]" <<
 				"[LINE: "<< setw(10) << sym.lineNum << "]" << endl;
-			savedQ.pop();
 		}
 		cout << "______________________________________________________________________" << endl;
 	}
 }
 
-// type checks the AST
-// &node	: the current node being analyzed
-void Semantic_Analyzer::typeCheck(AST_Node& node)
+// function to walk the CST once, laying out the AST in pre-order while resolving each id to its declaration,
+// tracking initialization and use, and inferring and checking types as each AST node is finished
+// node		: the current node being analyzed
+// scope	: scope of this node
+void Semantic_Analyzer::analyze(Node& node, int scope)
 {
-	string& name = node.name;
-	vector<AST_Node>& children = *node.children;
-	int lineNum;
-	if(children.size() > 1 && children.at(1).type == "id") 
-		children.at(1).type = "void"; // change id type to void since this is an undeclared id in my underlying logic
-	if(name == "<AssignmentStatement>") // must check assignment's type matches variable's type
+	int& lineNum = node.lineNum;
+	queue<Node>& children = *node.children;
+	
+	// analyze the given node of the CST and determine:
+	//	1) Should this node go on the AST? For some nodes, such as <BooleanExpr>, this is conditional.
+	//	2) What child nodes of this node are important for the AST?
+	switch(node.kind)
 	{
-		if(!(children.at(0).type == "id") && !(children.at(0).type == "void")
-			&& children.at(0).type != children.at(1).type)
+		case N_PROGRAM:
+			analyze(children.front(), scope); // <Block>
+			break;
+		case N_BLOCK:
 		{
-			lineNum = children.at(0).lineNum;
-			cout << "[ERROR]Line " << lineNum << ": (Type Mismatch) " << "The variable " << children.at(0).name <<
-				" can only be assigned a type of " << children.at(0).type << ", not " << children.at(1).type << "." <<endl;
-			++numErrors;
+			int block = emit(N_BLOCK, 0, node.type, scope, lineNum);
+			// new scope
+			Table_Node newTN;
+			newTN.scope = scope+1;
+			for(int i = 0; i < 26; ++i)
+				newTN.slots[i] = -1; // nothing is declared in the new scope yet
+			scopeStack.push_back(newTN);
+			// scope setting
+			if(scopeMap.count(scope+1) == 0) scopeMap.emplace(scope+1, 1); // first of this scope
+			else ++scopeMap.at(scope+1); // increment subscope otherwise
+			children.pop(); // remove [{]
+			analyze(children.front(), scope+1); // <StatementList>
+			scopeStack.pop_back(); // leaving the block's scope
+			close(block);
+			break;
 		}
-	}
-	else if(name == "<+>") // must check right child node has a type of int
-	{
-		if(!(children.at(1).type == "id") && !(children.at(1).type == "void")
-			&& children.at(1).type != "int")
+		case N_STATEMENT_LIST:
+			while(!children.empty())
+			{
+				analyze(children.front(), scope);
+				children.pop();
+			}
+			break;
+		case N_STATEMENT:
+		case N_EXPR:
+			analyze(children.front(), scope); // can only have one child node
+			break;
+		case N_PRINT_STATEMENT:
 		{
-			lineNum = children.at(1).lineNum;
-			cout << "[ERROR]Line " << lineNum << ": (Type Mismatch) " << "Only integers may be added together; a " <<
-				children.at(1).type << " was found in your addition equation." << endl;
-			++numErrors;
+			int print = emit(N_PRINT_STATEMENT, 0, node.type, scope, lineNum);
+			children.pop(); // remove [print]
+			children.pop(); // remove [(]
+			analyze(children.front(), scope); // <Expr> to print
+			close(print);
+			break;
 		}
-	}
-	else if(name == "<==>" || name == "<!=>") // must check both child nodes have the same type
-	{
-		if(!(children.at(0).type == "id") && !(children.at(0).type == "void") &&
-			!(children.at(1).type == "id") && !(children.at(1).type == "void") &&
-			children.at(0).type != children.at(1).type)
+		case N_ASSIGNMENT_STATEMENT:
 		{
-			lineNum = children.at(0).lineNum;
-			string grammar1 = (children.at(0).type == "int") ? "An " : "A ";
-			string grammar2 = (children.at(1).type == "int") ? "an " : "a ";
-			cout << "[ERROR]Line " << lineNum << ": (Type Mismatch) " << grammar1 << children.at(0).type << " " <<
-				" cannot be compared to " << grammar2 << children.at(1).type << " " <<
-				"." << endl;
-			++numErrors;
+			int assign = emit(N_ASSIGNMENT_STATEMENT, 0, node.type, scope, lineNum);
+			Node& id = children.front(); // [id]
+			int var = close(emit(N_ID, id.value, id.type, scope, id.lineNum));
+			children.pop(); // remove [id]
+			children.pop(); // remove [=]
+			// need to make sure this variable has been declared
+			int slot = resolve(AST[var].value); // check this scope, but also move up to enclosing scopes
+			if(slot != -1) // if the variable was declared in scope
+			{
+				Symbol& sym = symbols.at(slot);
+				AST[var].slot = slot; // record the slot on the AST node
+				AST[var].scope = sym.scope; // set the AST node's scope to the symbol's
+				AST[var].subscope = sym.subscope; // set AST node's subscope to the symbol's
+				AST[var].type = sym.type; // assign the variable AST_Node its type here
+				sym.initialized = true;
+			}
+			else // if the symbol was not declared in scope
+			{
+				cout << "[ERROR]Line " << AST[var].lineNum << ": " << "The variable " << nodeName(AST[var]) <<
+					" has not been declared within this scope." << endl;
+				++numErrors;
+				resolving = false; // don't check the ids on the right hand side
+			}
+			analyze(children.front(), scope); // <Expr>
+			resolving = true;
+			close(assign);
+			break;
 		}
-	}
-	for(vector<AST_Node>::iterator it=children.begin(); it != children.end(); ++it) // for each child node
-		typeCheck(*it); // recurse
-}
-
-// assigns types to each node of the AST
-// NOTE: types of variables (ids) are not assigned here, but are instead in constructSymbolTable
-// &node	 : the node being analyzed
-// $children : the children of &node
-// returns	 : a root AST_Node of the entire AST
-AST_Node Semantic_Analyzer::resolveTypes(Node& node, queue<Node>& children)
-{
-	string name = node.name;
-	AST_Node newNode;
-	newNode.name = name;
-	newNode.type = node.type;
-	newNode.scope = node.scope;
-	newNode.lineNum = node.lineNum;
-	newNode.children = new vector<AST_Node>;
-		
-	if(name == "[int]" || name == "[string]" || name == "[boolean]" || name == "[true]" || name == "[false]") // obvious types
-	{
-		if(name == "[int]") newNode.type = "int";
-		else if(name == "[string]") newNode.type = "string";
-		else if(name == "[boolean]" || name == "[true]" || name == "[false]") newNode.type = "boolean";
-	}
-	else if(!children.empty()) // if this node has children we'll have to recurse until we find the type for it
-	{
-		vector<AST_Node>*& newChildren = newNode.children; // the new AST will contain vector children instead of queues for better traversal
-		string newType = "void"; // default type
-		while(!children.empty()) // recurse through the children
+		case N_VAR_DECL:
 		{
-			AST_Node n = resolveTypes(children.front(), *children.front().children);
-			(*newChildren).push_back(n);
-			if(n.type == "int" || n.type == "string" || n.type == "boolean")
-				newType = n.type; // the new AST_Node will have the same type as the children
-			children.pop();
+			int varDecl = emit(N_VAR_DECL, 0, node.type, scope, lineNum);
+			analyze(children.front(), scope); // <type>
+			children.pop(); // remove <type>
+			Node& id = children.front(); // [id]
+			int var = close(emit(N_ID, id.value, id.type, scope, id.lineNum));
+			declare(varDecl+1, var);
+			close(varDecl);
+			break;
 		}
-		// make sure boolean operators are always of type boolean
-		if(name == "<==>" || name == "<!=>") newNode.type = "boolean";
-		else newNode.type = newType;
-		newNode.children = newChildren;
-	}
-	return newNode;
-}
-
-// function to construct the symbol table and also catch scope & type errors along the way
-// n				: the current node in the AST being analyzed
-// *tn				: the symbol table node we are currently adding symbols to
-// &symTblPrintQ	: the print queue for all symbols
-// scope			: the current scope
-// scope			: for parallel depth scopes (e.g. 2, 2-2, 2-3; where these 3 scopes all have the root scope as a parent)
-void Semantic_Analyzer::constructSymbolTable(AST_Node& n, Table_Node* tn, queue<Symbol*>& symTblPrntQ, int scope)
-{
-	Table_Node* toPass = tn; // table node to pass recursively
-	Table_Node& curTN = *tn; // let's us work with the actual table node
-	vector<AST_Node>& children = *n.children; // get the node's children
-	
-	if(n.name == "<Block>") // new scope
-	{
-		unordered_map<string, Symbol&> symbols;
-		Table_Node* newTN = new Table_Node; //{++scope, symbols, tn};
-		newTN->scope = ++scope;
-		newTN->symbols = symbols;
-		newTN->parent = tn;
-		toPass = newTN;
-		// scope setting
-		if(scopeMap.count(scope) == 0) scopeMap.emplace(scope, 1); // first of this scope
-		else // increment subscope otherwise
+		case N_WHILE_STATEMENT:
+		case N_IF_STATEMENT:
 		{
-			int newSubscope = ++scopeMap.at(scope);
-			scopeMap.erase(scope);
-			scopeMap.emplace(scope, newSubscope);
+			int statement = emit(node.kind, 0, node.type, scope, lineNum);
+			children.pop(); // remove [wile] / [if]
+			analyze(children.front(), scope); // <BooleanExpr>
+			children.pop(); // remove <BooleanExpr>
+			analyze(children.front(), scope); // <Block>
+			close(statement);
+			break;
 		}
-	}
-	else if(n.name == "<VarDecl>") // variable declaration - add symbol
-	{
-		int lineNum = children.front().lineNum; // line number of the symbol
-		string type = children.front().name; // int/string/boolean
-		string key = children.at(1).name; // the variable
-		children.at(1).scope = scope; // set the AST node's scope
-		children.at(1).subscope = scopeMap.at(scope); // assign a subscope to this ast node
-		Symbol* sPointer = new Symbol; //{key, type, lineNum, 0, false, "", false, false, scope, scopeMap.at(scope)}; // create a new symbol with the type
-		sPointer->name = key;
-		sPointer->type = type;
-		sPointer->lineNum = lineNum;
-		sPointer->intVal = 0;
-		sPointer->boolVal = false;
-		sPointer->stringVal = "";
-		sPointer->initialized = false;
-		sPointer->used = false;
-		sPointer->scope = scope;
-		sPointer->subscope = scopeMap.at(scope);
-		Symbol& symbol = *sPointer;
-		if(curTN.symbols.emplace(key, symbol).second == false) // add the symbol to the symbol table node if it doesn't yet exist
+		case N_TYPE:
+		case N_CHAR_LIST:
+		case N_BOOLOP:
+		case N_BOOLVAL:
 		{
-			cout << "[ERROR]Line " << lineNum << ": " << "The variable " << key <<
-			" was already declared in this scope on line " << curTN.symbols.at(key).lineNum << "." << endl;
-			++numErrors; // increment the number of errors found
+			Node& child = children.front();
+			Kind kind = child.kind;
+			int value = child.value;
+			if(node.kind == N_CHAR_LIST) 
+			{
+				// add this string to the stringsMap for use in code generation, and refer to it by its index
+				if(stringsMap.emplace(child.text, strings.size()).second) strings.push_back(child.text);
+				value = stringsMap.at(child.text);
+			}
+			if(node.kind == N_BOOLOP) kind = (kind == N_EQUALS) ? N_EQUAL : N_NOT_EQUAL; // modify the boolop a little for the AST
+			close(emit(kind, value, child.type, scope, child.lineNum));
+			break;
 		}
-		else
+		case N_INT_EXPR:
 		{
-			symTblPrntQ.push(sPointer); // add symbol to print queue
-			children.at(1).type = type.substr(1, type.length()-2); // assign the variable AST_Node its type here
+			if(children.size() == 1) // if the int expr is just a digit
+				analyze(children.front(), scope);
+			else
+			{
+				int integer = emit(N_ADD, 0, TYPE_INT, scope, lineNum);
+				analyze(children.front(), scope); // [digit]
+				children.pop(); // remove [digit]
+				children.pop(); // remove [+]
+				analyze(children.front(), scope); // <expr>
+				close(integer);
+			}
+			break;
 		}
-		return; // don't continue analyzing the child nodes
-	}
-	else if(n.name == "<AssignmentStatement>") // need to make sure this variable has been declred
-	{
-		AST_Node& var = children.front(); // left hand side of expression (the variable)
-		Table_Node* scopeChecker = tn; // start checking this scope, but also move up to enclosing scopes
-		while(scopeChecker != nullptr) // while there is an enclosing scope to check
+		case N_STRING_EXPR:
+			children.pop(); // remove ["]
+			analyze(children.front(), scope); // <CharList>
+			break;
+		case N_BOOLEAN_EXPR:
 		{
-			if((*scopeChecker).symbols.count(var.name) == 1) // if the variable was declared in this scope
-			{	
-				Symbol& sym = (*scopeChecker).symbols.at(var.name);
-				var.scope = sym.scope; // set the AST node's scope to the symbol's
-				var.subscope = sym.subscope; // set AST node's subscope to the symbol's
-				sym.initialized = true;
-				var.type = sym.type.substr(1, sym.type.length()-2); // assign the variable AST_Node its type here
-				constructSymbolTable(children.at(1), toPass, symTblPrntQ, scope); // recurse on right side of assignment statement
-				return; // symbol was indeed declared - no problems
-			}			
-			scopeChecker = (*scopeChecker).parent; // go to next enclosing scope
+			if(children.size() == 1) // if the only child node is <boolval>
+			{
+				analyze(children.front(), scope);
+			}
+			else // we found (Expr boolop Expr)
+			{
+				children.pop(); // remove [(]
+				Node n1 = children.front(); // first <Expr>
+				children.pop(); // remove <Expr>
+				// the boolean node takes the kind of the boolean operator
+				Kind kind = (children.front().children->front().kind == N_EQUALS) ? N_EQUAL : N_NOT_EQUAL;
+				children.pop(); // remove <boolop>
+				Node n2 = children.front(); // second <Expr>
+				int boolean = emit(kind, 0, TYPE_BOOLEAN, scope, lineNum);
+				analyze(n1, scope); // add first node to compare
+				analyze(n2, scope); // add second node to compare
+				close(boolean);
+			}
+			break;
 		}
-		// if the symbol was not declared in scope
-		cout << "[ERROR]Line " << var.lineNum << ": " << "The variable " << var.name <<
-			" has not been declared within this scope." << endl;
-		++numErrors;
-		return; // don't continue analyzing the child nodes
-	}
-	else if(n.type == "id") // need to make sure the variable was initialized
-	{
-		Table_Node*& scopeChecker = tn; // start checking this scope, but also move up to enclosing scopes
-		while(scopeChecker != nullptr) // while there is an enclosing scope to check
+		case N_TRUE:
+		case N_FALSE:
+		case N_EQUALS:
+		case N_NOT_EQUALS:
+			close(emit(node.kind, 0, TYPE_BOOLEAN, scope, lineNum));
+			break;
+		case N_PLUS:
+			close(emit(node.kind, 0, TYPE_INT, scope, lineNum));
+			break;
+		// these nodes should never even pass through this function, but this is here to catch them in case they do
+		case N_IF:
+		case N_INT:
+		case N_BOOLEAN:
+		case N_STRING:
+		case N_PRINT:
+		case N_WHILE:
+		case N_QUOTE:
+		case N_OPEN_PAREN:
+		case N_CLOSE_PAREN:
+		case N_OPEN_BRACE:
+		case N_CLOSE_BRACE:
+		case N_ASSIGN:
+		case N_EOF:
+		case N_EPSILON:
+			break; // do nothing
+		default: // id, digit
 		{
-			if((*scopeChecker).symbols.count(n.name) == 1) // if the variable was declared in this scope
-			{	
-				Symbol& sym = (*scopeChecker).symbols.at(n.name);
-				n.scope = sym.scope; // set the AST node's scope to the symbol's
-				n.subscope = sym.subscope; // set AST node's subscope to the symbol's
-				n.type = sym.type.substr(1, sym.type.length()-2); // assign the AST_Node its type here
-				if(sym.initialized == true) 
-				{
-					sym.used = true; // we now know the symbol has been used at least once
-				}
-				else
-				{
-					cout << "[WARN]Line " << n.lineNum << ": " << "The variable " << n.name <<
-						" has not been initialized within this scope." << endl;
-					++numWarn;
-				}
-				return; // don't go on to report variable not declared, as it was
-			}			
-			scopeChecker = (*scopeChecker).parent; // go to next enclosing scope
+			int n = close(emit(node.kind, node.value, node.type, scope, lineNum));
+			if(node.kind == N_ID && resolving) use(n); // need to make sure the variable was initialized
+			break;
 		}
-		// if the symbol was not declared nor initialized in scope
-		cout << "[ERROR]Line " << n.lineNum << ": " << "The variable " << n.name <<
-			" has neither been initialized nor declared within this scope." << endl;
-		++numErrors;
-		return; // don't continue analyzing the child nodes
-	}
-	
-	for(vector<AST_Node>::iterator it=children.begin(); it != children.end(); ++it) // for each child node
-	{
-		constructSymbolTable(*it, toPass, symTblPrntQ, scope); // recurse
 	}
 }
 
-// function to make a node to push onto the current AST queue
-// name		: name of the node
+// function to append a node to the AST as the next child of the innermost node still being laid out
+// kind		: kind of the node
+// value	: payload of the node (letter of an id, number of a digit, index of a string literal)
 // type		: data type associated with the node
 // scope	: scope of the node
 // lineNum	: the line number
-// returns	: a node
-Node Semantic_Analyzer::nmake(string name, string type, int scope, int lineNum)
+// returns	: index of the node, which stays open for children until it is closed
+int Semantic_Analyzer::emit(Kind kind, int value, Type type, int scope, int lineNum)
 {
-	queue<Node>* children = new queue<Node>;
-	Node n = {name, type, scope, lineNum, children}; // initialize with type void and scope 0 to be changed during AST creation
-	return n;
+	AST_Node n;
+	n.kind = kind;
+	n.value = value;
+	n.type = type;
+	n.scope = scope;
+	n.subscope = 0;
+	n.lineNum = lineNum;
+	n.numChildren = 0;
+	n.slot = -1; // ids are resolved once they are in place
+	n.end = AST.size()+1;
+	if(!open.empty()) ++AST[open.back()].numChildren; // one more child for the enclosing node
+	AST.push_back(n);
+	open.push_back(AST.size()-1);
+	return AST.size()-1;
 }
 
-// prints out the abstract syntax tree
-// n		: the current node
-// level	: the depth of this node
-void Semantic_Analyzer::printAST(AST_Node n, int level)
+// function to finish a node once all of its children are laid out, giving it its type and type checking it
+// NOTE: ids are typed by the symbol they resolve to, not here
+// index	: index of the node
+// returns	: index of the node
+int Semantic_Analyzer::close(int index)
 {
-	for(int i=0; i < level; ++i) // for the node's depth
-		cout << "-"; // print out a corresponding number of dashes
-	cout << n.name << " (" << n.type << ")" <<
-	// "(Line No. " << n.lineNum << ")" << // print node's line number 
-	// "(Type " << n.type << ")" << // print node's name
-	endl;
-	vector<AST_Node> children = *n.children; // get the node's children
-	for(vector<AST_Node>::iterator it = children.begin(); it != children.end(); ++it) // for each child node
+	open.pop_back();
+	AST_Node& n = AST[index];
+	n.end = AST.size(); // the subtree ends after its last descendant
+	switch(n.kind)
 	{
-		printAST(*it, level+1); // recurse
+		case N_INT: // obvious types
+			n.type = TYPE_INT;
+			break;
+		case N_STRING:
+			n.type = TYPE_STRING;
+			break;
+		case N_BOOLEAN:
+		case N_TRUE:
+		case N_FALSE:
+			n.type = TYPE_BOOLEAN;
+			break;
+		default:
+			if(n.numChildren > 0) // the node has the same type as its children
+			{
+				Type newType = TYPE_VOID; // default type
+				for(int c = index+1; c < n.end; c = AST[c].end) // for each child node
+				{
+					// an id's own type does not carry up to its parent
+					if(AST[c].kind != N_ID && (AST[c].type == TYPE_INT || AST[c].type == TYPE_STRING || AST[c].type == TYPE_BOOLEAN))
+						newType = AST[c].type;
+				}
+				// make sure boolean operators are always of type boolean
+				if(n.kind == N_EQUAL || n.kind == N_NOT_EQUAL) n.type = TYPE_BOOLEAN;
+				else n.type = newType;
+			}
+			break;
 	}
+	if(n.numChildren > 1) typeCheck(index); // every id below the node is resolved by now
+	return index;
 }
 
-// function to construct an AST from a CST
-// node		: the current node being analyzed
-// nodes	: the queue of child nodes we are adding to
-// scope	: scope of this node
-void Semantic_Analyzer::constructAST(Node& node, queue<Node>& AST, int scope)
+// type checks a node of the AST with at least two children
+// index	: index of the node
+void Semantic_Analyzer::typeCheck(int index)
 {
-	string& name = node.name;
-	string& type = node.type;
-	int& lineNum = node.lineNum;
-	queue<Node>& children = *node.children;
-	
-	// analyze the given node of the CST and determine:
-	//	1) Should this node go on the AST? For some nodes, such as <BooleanExpr>, this is conditional.
-	//	2) What child nodes of this node are important for the AST?
-	if(name == "<Program>")
-	{
-		Node& n = children.front();	// <Block>			
-		constructAST(n, AST, scope);
-	}
-	else if(name == "<Block>")
-	{
-		// cout << "Analyzing block" << endl;
-		Node block = nmake(name, type, scope, lineNum);
-		AST.push(block);
-		children.pop(); // remove [{]
-		Node& n = children.front(); // <StatementList>
-		constructAST(n, *block.children, scope+1);
-	}
-	else if(name == "<StatementList>")
-	{
-		// cout << "Analyzing stmt list" << endl;
-		while(!children.empty())
-		{
-			Node& n = children.front();
-			constructAST(n, AST, scope);
-			children.pop();
-		}
-		return;
-	}
-	else if(name == "<Statement>" || name == "<Expr>")
+	AST_Node& left = AST[index+1]; // the first child
+	AST_Node& right = AST[left.end]; // the second child
+	stringstream error; // the error found, if any
+	if(right.type == TYPE_ID) 
+		right.type = TYPE_VOID; // change id type to void since this is an undeclared id in my underlying logic
+	switch(AST[index].kind)
 	{
-		// cout << "Analyzing stmt" << endl;
-		Node& n = children.front(); // can only have one child node
-		constructAST(n, AST, scope);
-	}
-	else if(name == "<PrintStatement>")
-	{
-		// cout << "Analyzing print stmt" << endl;
-		Node print = nmake(name, type, scope, lineNum);
-		AST.push(print);
-		children.pop(); // remove [print]
-		children.pop(); // remove [(]
-		Node& n = children.front(); // <Expr> to print
-		constructAST(n, *print.children, scope);
-	}
-	else if(name == "<AssignmentStatement>")
-	{
-		// cout << "Analyzing assign stmt" << endl;
-		Node assign = nmake(name, type, scope, lineNum);
-		AST.push(assign);
-		Node& n = children.front(); // [id]
-		constructAST(n, *assign.children, scope);
-		children.pop(); // remove [id]
-		children.pop(); // remove [=]
-		n = children.front(); // <Expr>
-		constructAST(n, *assign.children, scope);
-	}
-	else if(name == "<VarDecl>")
-	{
-		// cout << "Analyzing var decl" << endl;
-		Node varDecl = nmake(name, type, scope, lineNum);
-		AST.push(varDecl);
-		while(!children.empty())
-		{
-			Node& n = children.front();
-			if(n.name == "<type>")
+		case N_ASSIGNMENT_STATEMENT: // must check assignment's type matches variable's type
+			if(!(left.type == TYPE_ID) && !(left.type == TYPE_VOID)
+				&& left.type != right.type)
 			{
-				constructAST(n, *varDecl.children, scope);
-				while(!children.empty())
-				{
-					n = children.front();
-					if(n.type == "id")
-					{
-						constructAST(n, *varDecl.children, scope);
-						return;
-					}
-					children.pop();
-				}
+				error << "[ERROR]Line " << left.lineNum << ": (Type Mismatch) " << "The variable " << nodeName(left) <<
+					" can only be assigned a type of " << typeName(left.type) << ", not " << typeName(right.type) << ".";
 			}
-			children.pop();
-		}
+			break;
+		case N_ADD: // must check right child node has a type of int
+			if(!(right.type == TYPE_ID) && !(right.type == TYPE_VOID)
+				&& right.type != TYPE_INT)
+			{
+				error << "[ERROR]Line " << right.lineNum << ": (Type Mismatch) " << "Only integers may be added together; a " <<
+					typeName(right.type) << " was found in your addition equation.";
+			}
+			break;
+		case N_EQUAL: // must check both child nodes have the same type
+		case N_NOT_EQUAL:
+			if(!(left.type == TYPE_ID) && !(left.type == TYPE_VOID) &&
+				!(right.type == TYPE_ID) && !(right.type == TYPE_VOID) &&
+				left.type != right.type)
+			{
+				string grammar1 = (left.type == TYPE_INT) ? "An " : "A ";
+				string grammar2 = (right.type == TYPE_INT) ? "an " : "a ";
+				error << "[ERROR]Line " << left.lineNum << ": (Type Mismatch) " << grammar1 << typeName(left.type) << " " <<
+					" cannot be compared to " << grammar2 << typeName(right.type) << " " <<
+					".";
+			}
+			break;
+		default:
+			break;
 	}
-	else if(name == "<WhileStatement>" || name == "<IfStatement>")
+	if(error.tellp() > 0) // if there was a type error
 	{
-		// cout << "Analyzing while/if stmt" << endl;
-		Node node = nmake(name, type, scope, lineNum);
-		AST.push(node);
-		children.pop(); // remove [wile] / [if]
-		Node& n = children.front(); // <BooleanExpr>
-		constructAST(n, *node.children, scope);
-		children.pop(); // remove <BooleanExpr>
-		n = children.front(); // <Block>
-		constructAST(n, *node.children, scope);
+		typeErrors.emplace(index, error.str());
+		++numErrors;
 	}
-	else if(name == "<type>" || name == "<CharList>" || name == "<boolop>" || name == "<boolval>")
+}
+
+// function to add the symbol a variable declaration declares
+// every declaration gets the next dense slot in the symbol table
+// typeNode	: index of the declaration's type node
+// var		: index of the declared variable's node
+void Semantic_Analyzer::declare(int typeNode, int var)
+{
+	int lineNum = AST[typeNode].lineNum; // line number of the symbol
+	Type type = AST[typeNode].type; // int/string/boolean
+	int key = AST[var].value; // the variable
+	int scope = scopeStack.back().scope; // the current scope
+	AST[var].scope = scope; // set the AST node's scope
+	AST[var].subscope = scopeMap.at(scope); // assign a subscope to this ast node
+	int& slot = scopeStack.back().slots[key - 'a']; // the letter's slot in the current scope
+	if(slot != -1) // the symbol already exists in this scope
 	{
-		// cout << "Analyzing type/char list/boolop/boolval" << endl;
-		queue<Node>& children = *node.children;
-		Node& node = children.front();
-		if(name == "<CharList>") 
-		{
-			node.type = "string";
-			// add this string to the stringsMap for use in code generation
-			stringsMap.emplace(node.name.substr(2, node.name.length()-4), 0);
-		}
-		if(name == "<boolop>") node.name = "<" + node.name.substr(1, node.name.length()-2) + ">"; // modify the boolop a little for the AST
-		AST.push(nmake(node.name, node.type, scope, node.lineNum));
+		cout << "[ERROR]Line " << lineNum << ": " << "The variable " << kindName(N_ID, key, "") <<
+		" was already declared in this scope on line " << symbols.at(slot).lineNum << "." << endl;
+		++numErrors; // increment the number of errors found
 		return;
 	}
-	else if(name == "<IntExpr>")
+	Symbol symbol; // create a new symbol with the type
+	symbol.name = key;
+	symbol.type = type;
+	symbol.lineNum = lineNum;
+	symbol.intVal = 0;
+	symbol.boolVal = false;
+	symbol.stringVal = "";
+	symbol.initialized = false;
+	symbol.used = false;
+	symbol.scope = scope;
+	symbol.subscope = scopeMap.at(scope);
+	slot = symbols.size(); // the next dense slot
+	symbols.push_back(symbol); // add the symbol to the symbol table
+	AST[var].slot = slot; // record the slot on the AST node
+	AST[var].type = type; // assign the variable AST_Node its type here
+}
+
+// function to resolve an id that uses a variable's value, making sure the variable was declared and initialized
+// index	: index of the id's node
+void Semantic_Analyzer::use(int index)
+{
+	AST_Node& n = AST[index];
+	int slot = resolve(n.value); // check this scope, but also move up to enclosing scopes
+	if(slot == -1) // if the symbol was not declared nor initialized in scope
 	{
-		// cout << "Analyzing int expr" << endl;
-		Node& n = children.front();
-		if(children.size() == 1) // if the int expr is just a digit
-			constructAST(n, AST, scope);
-		else
-		{
-			Node integer = nmake("<+>", "int", scope, lineNum);
-			AST.push(integer);
-			constructAST(n, *integer.children, scope);
-			children.pop(); // remove [digit]
-			children.pop(); // remove [+]
-			n = children.front(); // <expr>
-			constructAST(n, *integer.children, scope);
-		}
+		cout << "[ERROR]Line " << n.lineNum << ": " << "The variable " << nodeName(n) <<
+			" has neither been initialized nor declared within this scope." << endl;
+		++numErrors;
 		return;
 	}
-	else if(name == "<StringExpr>")
-	{
-		// cout << "Analyzing string expr" << endl;
-		children.pop(); // remove ["]
-		Node& n = children.front(); // <CharList>
-		constructAST(n, AST, scope);
-	}
-	else if(name == "<BooleanExpr>")
-	{
-		// cout << "Analyzing bool expr" << endl;
-		Node& n = children.front(); // <boolop>
-		if(children.size() == 1) // if the only child node is <boolval>
-		{
-			constructAST(n, AST, scope);
-		}
-		else // we found (Expr boolop Expr)
-		{
-			Node boolean = nmake(name, "boolean", scope, lineNum);
-			children.pop(); // remove [(]
-			Node n1 = children.front(); // first <Expr>
-			children.pop(); // remove <Expr>
-			n = children.front(); // <boolop>
-			constructAST(n, *boolean.children, scope);
-			children.pop(); // remove <boolop>
-			Node n2 = children.front(); // second <Expr>
-			// logic for changing the name of the boolean node to match the given boolean operator
-			queue<Node>& nodes = *boolean.children;
-			boolean.name = nodes.front().name; // change name to boolean operator
-			nodes.pop(); // remove boolean operator
-			constructAST(n1, *boolean.children, scope); // add first node to compare
-			constructAST(n2, *boolean.children, scope); // add second node to compare
-			AST.push(boolean);
-		}
-	}
-	else if(name == "[true]" || name == "[false]" || name == "[==]" || name == "[!=]")
+	Symbol& sym = symbols.at(slot);
+	n.slot = slot; // record the slot on the AST node
+	n.scope = sym.scope; // set the AST node's scope to the symbol's
+	n.subscope = sym.subscope; // set AST node's subscope to the symbol's
+	n.type = sym.type; // assign the AST_Node its type here
+	if(sym.initialized == true) 
 	{
-		// cout << "Analyzing true/false/==/!=" << endl;
-		AST.push(nmake(name, "boolean", scope, lineNum));
-		return;
+		sym.used = true; // we now know the symbol has been used at least once
 	}
-	else if(name == "[+]")
+	else
 	{
-		// cout << "Analyzing +" << endl;
-		AST.push(nmake(name, "int", scope, lineNum));
-		return;
+		cout << "[WARN]Line " << n.lineNum << ": " << "The variable " << nodeName(n) <<
+			" has not been initialized within this scope." << endl;
+		++numWarn;
 	}
-	// these nodes should never even pass through this function, but this is here to catch them in case they do
-	else if(name == "[if]" ||
-			name == "[int]" ||
-			name == "[boolean]" ||
-			name == "[string]" ||
-			name == "[print]" ||
-			name == "[while]" ||
-			name == "[\"]" ||
-			name == "[(]" ||
-			name == "[)]" ||
-			name == "[{]" ||
-			name == "[}]" ||
-			name == "[=]" ||
-			name == "[$]" ||
-			name == "[epsilon]")
+}
+
+// function to find the declaration an id refers to
+// letter	: the letter of the id
+// returns	: the slot of the innermost declaration of the letter in scope, or -1 if there is none
+int Semantic_Analyzer::resolve(int letter)
+{
+	for(int s = scopeStack.size()-1; s >= 0; --s) // start at this scope, but also move up to enclosing scopes
 	{
-		// cout << "Analyzing discardable node" << endl;
-		return; // do nothing
+		if(scopeStack[s].slots[letter - 'a'] != -1) // if the variable was declared in this scope
+			return scopeStack[s].slots[letter - 'a'];
 	}
-	else // id, digit
+	return -1;
+}
+
+// function to get the name an AST node is printed with
+// &n		: the node
+// returns	: its name, e.g. <Block>, [a] or ["foo"]
+string Semantic_Analyzer::nodeName(AST_Node& n)
+{
+	if(n.kind == N_CHARS) return kindName(n.kind, n.value, strings.at(n.value)); // string literals are stored by index
+	return kindName(n.kind, n.value, "");
+}
+
+// prints out the abstract syntax tree
+void Semantic_Analyzer::printAST()
+{
+	vector<int> ends; // where the subtrees enclosing the current node end
+	for(int n = 0; n < (int)AST.size(); ++n) // for each node, in pre-order
 	{
-		// cout << "Analyzing id/digit" << endl;
-		if(type == "digit") type = "int";
-		AST.push(nmake(name, type, scope, lineNum));
-		return;
+		while(!ends.empty() && ends.back() <= n) // leave the subtrees that ended
+			ends.pop_back();
+		for(int i=0; i < (int)ends.size(); ++i) // for the node's depth
+			cout << "-"; // print out a corresponding number of dashes
+		cout << nodeName(AST[n]) << " (" << typeName(AST[n].type) << ")" <<
+		// "(Line No. " << AST[n].lineNum << ")" << // print node's line number 
+		// "(Type " << AST[n].type << ")" << // print node's name
+		endl;
+		ends.push_back(AST[n].end); // its children are one level deeper
 	}
 }
\ No newline at end of file